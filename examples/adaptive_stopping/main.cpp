@@ -0,0 +1,83 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// Benchmark example: 
+//   - Stopping each benchmark once its mean is precise enough, instead of after fixed iterations
+//   - Bounding the run by a maximum number of iterations and a time budget
+//   - Reporting why each benchmark stopped
+
+//------------------------------------------------------------------------
+// This is free and unencumbered software released into the public domain.
+//
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+//
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to <http://unlicense.org/>
+//------------------------------------------------------------------------
+
+
+#include <chrono>
+#include <cstdio>
+#include <emb/emb.hpp>
+#include <emb/reporters/csv.hpp>
+
+using Benchmarker =
+    emb::Benchmarker<std::chrono::steady_clock, std::chrono::duration<double, std::micro>>;
+
+/// A stable kernel, which needs few iterations
+void benchmark_stable(Benchmarker::State& s) {
+  for (auto _ : s)
+    for (int i = 0; i < 1000; i++)
+      emb::dontOptimize(i);
+}
+
+/// A kernel with varying work, which needs more iterations
+void benchmark_noisy(Benchmarker::State& s) {
+  unsigned x = 1;
+  for (auto _ : s) {
+    x = x * 1103515245 + 12345;
+    for (unsigned i = 0; i < (x >> 16) % 4000; i++)
+      emb::dontOptimize(i);
+  }
+}
+
+/// A slow kernel, which exhausts the time budget first
+void benchmark_slow(Benchmarker::State& s) {
+  unsigned x = 1;
+  for (auto _ : s) {
+    x = x * 1103515245 + 12345;
+    for (unsigned i = 0; i < 100000 + (x >> 16) % 100000; i++)
+      emb::dontOptimize(i);
+  }
+}
+
+int main() {
+  Benchmarker benchmarker;
+  benchmarker.registerBenchmark("benchmark_stable", benchmark_stable);
+  benchmarker.registerBenchmark("benchmark_noisy", benchmark_noisy);
+  benchmarker.registerBenchmark("benchmark_slow", benchmark_slow);
+
+  // Mean within 1% at 95% confidence, after at least 10 iterations, up to 1000000 iterations
+  // or 100ms of measured time
+  benchmarker.stopAtPrecision({10, 10, 1000000, std::chrono::milliseconds(100)});
+
+  // Results include the "stop" counter
+  emb::CsvReporter reporter(stdout);
+  benchmarker.runBenchmarks(reporter);
+}
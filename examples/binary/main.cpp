@@ -0,0 +1,73 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// Benchmark example: 
+//   - Reporting results as a compact binary stream, as we would through a serial port
+//   - Decoding the stream on the host: ./binary_example | emb_decode --format=csv
+
+//------------------------------------------------------------------------
+// This is free and unencumbered software released into the public domain.
+//
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+//
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to <http://unlicense.org/>
+//------------------------------------------------------------------------
+
+
+#include <chrono>
+#include <cstdio>
+#include <emb/emb.hpp>
+#include <emb/reporters/binary.hpp>
+
+/// The Benchmarker we'll use, as in the stl_chrono example
+using Benchmarker =
+    emb::Benchmarker<std::chrono::steady_clock, std::chrono::duration<double, std::nano>>;
+
+/// Empty loop Benchmark
+void benchmark_empty(Benchmarker::State& s) {
+  for (auto _ : s) {
+  }
+}
+
+/// Simple for loop benchmark
+void benchmark_loop(Benchmarker::State& s) {
+  for (auto _ : s) {
+    for (int i = 0; i < 10000; i++)
+      emb::dontOptimize(i);
+  }
+}
+
+/// Output for the binary reporter, writing each byte.
+/// In a microcontroller, this would write to a UART's transmit register.
+struct StdoutOutput {
+  void put(uint8_t byte) { std::putchar(byte); }
+};
+
+int main() {
+  Benchmarker benchmarker(10000);
+  EMB_MAKE_BENCHMARK(benchmarker, benchmark_empty);
+  EMB_MAKE_BENCHMARK(benchmarker, benchmark_loop, 1000);
+
+  benchmarker.context().set("board", "host");
+
+  StdoutOutput output;
+  emb::BinaryReporter<StdoutOutput> reporter(output);
+  benchmarker.runBenchmarks(reporter);
+}
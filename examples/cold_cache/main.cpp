@@ -0,0 +1,87 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// Benchmark example: 
+//   - Measuring code with cold data caches, as it runs in production
+//   - Evicting a registered working set, or streaming through a large buffer
+//   - Sizing the buffer from a machine profile written by tools/characterize, if given
+//   - Reporting cold and warm results side by side
+
+//------------------------------------------------------------------------
+// This is free and unencumbered software released into the public domain.
+//
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+//
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to <http://unlicense.org/>
+//------------------------------------------------------------------------
+
+
+#include <chrono>
+#include <cstdio>
+#include <emb/cache.hpp>
+#include <emb/emb.hpp>
+#include <emb/host.hpp>
+#include <emb/profile.hpp>
+#include <emb/reporters/csv.hpp>
+#include <vector>
+
+using Benchmarker =
+    emb::Benchmarker<std::chrono::steady_clock, std::chrono::duration<double, std::nano>>;
+
+/// A lookup table, as used by a request handler
+static unsigned table[64 * 1024];
+
+/// Benchmark of a few scattered lookups
+void benchmark_lookup(Benchmarker::State& s) {
+  for (auto _ : s) {
+    unsigned sum = 0;
+    for (unsigned i = 0; i < 16; i++)
+      sum += table[(i * 40503u) % (sizeof(table) / sizeof(table[0]))];
+    emb::dontOptimize(sum);
+  }
+}
+
+/// Size of the last-level cache: from a profile file, if given and characterized, or the host
+size_t lastLevelCacheSize(int argc, char** argv) {
+  static emb::Profile<> profile;
+  if (argc > 1 && profile.load(argv[1]) && profile.lastCacheLevelBytes())
+    return profile.lastCacheLevelBytes();
+  return emb::lastLevelCacheSize();
+}
+
+int main(int argc, char** argv) {
+  Benchmarker benchmarker(1000);
+  EMB_MAKE_BENCHMARK(benchmarker, benchmark_lookup);
+
+  // Where supported, flush the table's cache lines before each cold iteration.
+  // Otherwise, read through a buffer larger than the last-level cache.
+  emb::CacheEvictor<> evictor;
+  std::vector<char> buffer;
+  if (!evictor.add(table, sizeof(table))) {
+    size_t size = lastLevelCacheSize(argc, argv);
+    buffer.resize(size ? 2 * size : 64 * 1024 * 1024);
+    evictor = emb::CacheEvictor<>(buffer.data(), buffer.size());
+  }
+  benchmarker.coldCache(evictor);
+
+  // Each benchmark is reported warm, then cold, with a "cache" column
+  emb::CsvReporter reporter(stdout);
+  benchmarker.runBenchmarks(reporter);
+}
@@ -0,0 +1,80 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// Benchmark example: 
+//   - Using the ready-made command-line driver, emb::runMain
+//   - Filtering, repeating, shuffling and listing benchmarks from the command line
+//   - Choosing the report's format and file, e.g. --format=json --out=results.json
+
+//------------------------------------------------------------------------
+// This is free and unencumbered software released into the public domain.
+//
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+//
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to <http://unlicense.org/>
+//------------------------------------------------------------------------
+
+
+#include <algorithm>
+#include <chrono>
+#include <emb/emb.hpp>
+#include <emb/host.hpp>
+#include <emb/main.hpp>
+#include <vector>
+
+using Benchmarker = emb::Benchmarker<std::chrono::steady_clock>;
+
+void benchmark_sort_sorted(Benchmarker::State& s) {
+  std::vector<int> v(1000);
+  for (auto _ : s) {
+    for (size_t i = 0; i < v.size(); i++)
+      v[i] = static_cast<int>(i);
+    std::sort(v.begin(), v.end());
+    emb::clobberMemory();
+  }
+}
+
+void benchmark_sort_reversed(Benchmarker::State& s) {
+  std::vector<int> v(1000);
+  for (auto _ : s) {
+    for (size_t i = 0; i < v.size(); i++)
+      v[i] = static_cast<int>(v.size() - i);
+    std::sort(v.begin(), v.end());
+    emb::clobberMemory();
+  }
+}
+
+void benchmark_fill(Benchmarker::State& s) {
+  std::vector<int> v(1000);
+  for (auto _ : s) {
+    std::fill(v.begin(), v.end(), 1);
+    emb::clobberMemory();
+  }
+}
+
+// Run with --help for the options
+int main(int argc, char** argv) {
+  Benchmarker benchmarker(1000);
+  benchmarker.registerBenchmark("sort/sorted", benchmark_sort_sorted);
+  benchmarker.registerBenchmark("sort/reversed", benchmark_sort_reversed);
+  benchmarker.registerBenchmark("fill", benchmark_fill);
+  emb::describeHost(benchmarker.context());
+  return emb::runMain(argc, argv, benchmarker);
+}
@@ -0,0 +1,102 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// Benchmark example: 
+//   - Timers for POSIX clocks, from emb/timers/posix.hpp
+//   - Wall time and CPU time of multi-threaded benchmarks, with emb::WallCpuTimer
+//   - CPU time of the benchmark's thread only, with emb::ThreadCpuTimer
+
+//------------------------------------------------------------------------
+// This is free and unencumbered software released into the public domain.
+//
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+//
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to <http://unlicense.org/>
+//------------------------------------------------------------------------
+
+
+
+#include <chrono>
+#include <cstdio>
+#include <emb/emb.hpp>
+#include <emb/timers/posix.hpp>
+#include <thread>
+#include <vector>
+
+/// Some work for a thread
+void spin(int n) {
+  for (int i = 0; i < n; i++)
+    emb::dontOptimize(i);
+}
+
+/// Runs the work in a number of threads, and waits for them
+void spinThreads(int threads, int n) {
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; t++)
+    workers.emplace_back(spin, n);
+  for (auto& worker : workers)
+    worker.join();
+}
+
+/// Benchmarks the same work in 1 and 4 threads, and a sleep, which takes wall time but no CPU
+template <typename Benchmarker>
+void registerBenchmarks(Benchmarker& benchmarker) {
+  benchmarker.registerBenchmark("spin/1_thread", [](typename Benchmarker::State& s) {
+    for (auto _ : s)
+      spinThreads(1, 1000000);
+  });
+  benchmarker.registerBenchmark("spin/4_threads", [](typename Benchmarker::State& s) {
+    for (auto _ : s)
+      spinThreads(4, 1000000);
+  });
+  benchmarker.registerBenchmark("sleep", [](typename Benchmarker::State& s) {
+    for (auto _ : s)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  });
+}
+
+/// Prints the mean and, if measured, the CPU time counters
+struct Reporter {
+  template <typename Result>
+  void report(const Result& r) {
+    std::printf("%-16s %10.0fns", r.name, r.mean);
+    if (const emb::Property* cpu = r.counters.find("cpu_time_ns"))
+      std::printf("  cpu_time_ns %10lld", cpu->signed_value);
+    if (const emb::Property* utilization = r.counters.find("cpu_utilization"))
+      std::printf("  cpu_utilization %.2f", utilization->real);
+    std::printf("\n");
+  }
+};
+
+int main() {
+  Reporter reporter;
+
+  // Results in wall time, with counters for the CPU time of all threads
+  std::printf("emb::WallCpuTimer:\n");
+  emb::Benchmarker<emb::WallCpuTimer<>, double> wall_cpu(50);
+  registerBenchmarks(wall_cpu);
+  wall_cpu.runBenchmarks(reporter);
+
+  // Results in the CPU time of the benchmark's thread, which only starts and joins the others
+  std::printf("\nemb::ThreadCpuTimer:\n");
+  emb::Benchmarker<emb::ThreadCpuTimer, double> thread_cpu(50);
+  registerBenchmarks(thread_cpu);
+  thread_cpu.runBenchmarks(reporter);
+}
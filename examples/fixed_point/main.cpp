@@ -0,0 +1,111 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// Benchmark example: 
+//   - Statistics without floating-point operations, for targets without an FPU
+//   - Accumulating integer sums in the loop, computing mean and deviation only once
+//   - Combining them with other statistics, such as the minimum and maximum
+//   - Reporting fixed-point results with integer arithmetic
+
+//------------------------------------------------------------------------
+// This is free and unencumbered software released into the public domain.
+//
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+//
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to <http://unlicense.org/>
+//------------------------------------------------------------------------
+
+
+// Without the STL, we need to provide a declval implementation.
+// As it's only used in unevaluated contexts, a declaration is enough.
+template <typename T>
+T&& declval() noexcept;
+
+#define EMB_NO_STL
+#define EMB_DECLVAL declval
+
+#include <emb/emb.hpp>
+#include <stdio.h>
+#include <time.h>
+
+/// Timer with nanosecond integer ticks.
+/// In a microcontroller, this would read a hardware timer or a cycle counter.
+struct monotonic_timer {
+  static unsigned long long now() {
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1000000000ull + t.tv_nsec;
+  }
+};
+
+/// Fixed-point accumulator, with 8 fractional bits
+using Fixed = emb::Fixed<8>;
+
+/// The Benchmarker we'll use:
+///    - Our monotonic_timer class for providing time
+///    - Fixed-point accumulator, for fractional results without floating point
+///    - Storage for 2 benchmarks registered with registerBenchmark, without a vector.
+///    - Integer sums during the loop. No divisions until the results are computed.
+///    - The minimum and maximum iteration times
+using Statistics = emb::statistics::Set<emb::statistics::IntegerMoments<>, emb::statistics::Min,
+    emb::statistics::Max>;
+using Benchmarker = emb::Benchmarker<monotonic_timer, Fixed, 2, Statistics>;
+
+/// Empty loop Benchmark
+void benchmark_empty(Benchmarker::State& s) {
+  for (auto _ : s) {
+  }
+}
+
+/// Simple for loop benchmark
+void benchmark_loop(Benchmarker::State& s) {
+  for (auto _ : s) {
+    for (int i = 0; i < 1000; i++)
+      emb::dontOptimize(i);
+  }
+}
+
+/// Prints a fixed-point value with two decimal places, using only integer arithmetic
+void print(Fixed value) {
+  long long raw = value.raw();
+  long long hundredths = (raw % 256) * 100 / 256;
+  printf("%lld.%02lldns", raw / 256, hundredths);
+}
+
+/// A benchmark reporting class, using C's printf.
+/// Prints every statistic: mean, stddev, min and max.
+struct Reporter {
+  void report(const Benchmarker::Result& result) {
+    printf("%s\t%zu", result.name, result.iterations);
+    result.forEachStatistic([](const char* name, Fixed value) {
+      printf("\t%s ", name);
+      print(value);
+    });
+    printf("\n");
+  }
+};
+
+int main() {
+  Benchmarker benchmarker(10000);
+  benchmarker.registerBenchmark("benchmark_empty", benchmark_empty);
+  benchmarker.registerBenchmark("benchmark_loop", benchmark_loop);
+  Reporter reporter;
+  benchmarker.runBenchmarks(reporter);
+}
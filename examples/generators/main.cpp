@@ -0,0 +1,87 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// Benchmark example: 
+//   - Generating each iteration's input from a seeded generator, outside the timed region
+//   - Comparing a branchy kernel on predictable, biased and random inputs
+//   - Reporting the seed, so the inputs can be reproduced
+
+//------------------------------------------------------------------------
+// This is free and unencumbered software released into the public domain.
+//
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+//
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to <http://unlicense.org/>
+//------------------------------------------------------------------------
+
+
+#include <chrono>
+#include <cstdio>
+#include <emb/emb.hpp>
+#include <emb/inputs.hpp>
+#include <emb/reporters/csv.hpp>
+
+using Benchmarker =
+    emb::Benchmarker<std::chrono::steady_clock, std::chrono::duration<double, std::nano>>;
+
+/// Each iteration's input: a block of bytes
+struct Block {
+  unsigned char bytes[256];
+};
+
+/// The kernel: branches on the high bit of each byte
+unsigned countHigh(const Block& block) {
+  unsigned count = 0;
+  for (unsigned char b : block.bytes) {
+    if (b & 0x80) {
+      emb::dontOptimize(b);
+      count++;
+    }
+  }
+  return count;
+}
+
+/// Registers a benchmark of blocks where a byte is high with probability percent/100
+void registerBranches(Benchmarker& benchmarker, const char* name, unsigned percent) {
+  benchmarker.registerBenchmark(name, [percent](Benchmarker::State& s) {
+    // Created before the loop, so the first chunk is generated outside the timed region
+    auto blocks = emb::makeGenerator<64>(
+        [percent](emb::Random& random) {
+          Block block;
+          for (auto& b : block.bytes)
+            b = static_cast<unsigned char>(random.chance(percent, 100) ? 0x80 : 0);
+          return block;
+        },
+        42);
+    for (auto _ : s)
+      emb::dontOptimize(countHigh(s.input(blocks)));
+  });
+}
+
+int main() {
+  Benchmarker benchmarker(10000);
+  registerBranches(benchmarker, "branches/never", 0);
+  registerBranches(benchmarker, "branches/10%", 10);
+  registerBranches(benchmarker, "branches/50%", 50);
+
+  // Results include the "seed" counter
+  emb::CsvReporter reporter(stdout);
+  benchmarker.runBenchmarks(reporter);
+}
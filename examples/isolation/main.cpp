@@ -0,0 +1,100 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// Benchmark example: 
+//   - Running each benchmark in its own child process, independent of the ones before it
+//   - Surviving benchmarks that crash or hang, with a timeout
+//   - Reporting failures from a result's "error" counter
+
+//------------------------------------------------------------------------
+// This is free and unencumbered software released into the public domain.
+//
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+//
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to <http://unlicense.org/>
+//------------------------------------------------------------------------
+
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <emb/emb.hpp>
+#include <emb/isolation.hpp>
+#include <vector>
+
+using Benchmarker = emb::Benchmarker<std::chrono::steady_clock>;
+
+/// Leaves a fragmented heap behind, which later benchmarks don't inherit when isolated
+void benchmark_fragment(Benchmarker::State& s) {
+  static std::vector<void*> kept;
+  for (auto _ : s) {
+    void* small = std::malloc(48);
+    kept.push_back(std::malloc(4096));
+    std::free(small);
+  }
+}
+
+void benchmark_allocate(Benchmarker::State& s) {
+  for (auto _ : s) {
+    void* p = std::malloc(64);
+    emb::dontOptimize(p);
+    std::free(p);
+  }
+}
+
+/// Crashes halfway through
+void benchmark_crash(Benchmarker::State& s) {
+  for (auto _ : s)
+    if (s.iteration() == 500)
+      std::abort();
+}
+
+/// Never finishes
+void benchmark_hang(Benchmarker::State& s) {
+  for (auto _ : s)
+    while (true)
+      emb::clobberMemory();
+}
+
+/// Prints each result, or why it failed
+struct Reporter {
+  void report(const Benchmarker::Result& r) {
+    if (const emb::Property* error = r.counters.find("error"))
+      std::printf("%-20s failed: %s\n", r.name, error->string);
+    else
+      std::printf("%-20s %zu iterations, mean %lldns\n", r.name, r.iterations,
+          static_cast<long long>(r.mean.count()));
+  }
+};
+
+int main() {
+  Benchmarker benchmarker(1000);
+  EMB_MAKE_BENCHMARK(benchmarker, benchmark_fragment);
+  EMB_MAKE_BENCHMARK(benchmarker, benchmark_allocate);
+  EMB_MAKE_BENCHMARK(benchmarker, benchmark_crash);
+  EMB_MAKE_BENCHMARK(benchmarker, benchmark_hang);
+
+  // Each benchmark runs in a child process, killed if it takes over a second
+  emb::ForkIsolator isolator(1000);
+  benchmarker.isolate(isolator);
+
+  Reporter reporter;
+  benchmarker.runBenchmarks(reporter);
+}
@@ -0,0 +1,82 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// Benchmark example: 
+//   - Placing benchmarks in a constant table, in a linker section, with EMB_BENCHMARK
+//   - Running them without registering to a Benchmarker instance
+
+//------------------------------------------------------------------------
+// This is free and unencumbered software released into the public domain.
+//
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+//
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to <http://unlicense.org/>
+//------------------------------------------------------------------------
+
+
+#include <chrono>
+#include <emb/emb.hpp>
+#include <iostream>
+
+/// The Benchmarker we'll use, as in the stl_chrono example
+using Benchmarker =
+    emb::Benchmarker<std::chrono::steady_clock, std::chrono::duration<double, std::nano>>;
+
+/// Empty loop Benchmark
+void benchmark_empty(Benchmarker::State& s) {
+  for (auto _ : s) {
+  }
+}
+
+/// Simple for loop benchmark
+void benchmark_loop(Benchmarker::State& s) {
+  for (auto _ : s) {
+    for (int i = 0; i < 10000; i++)
+      emb::dontOptimize(i);
+  }
+}
+
+// Each EMB_BENCHMARK creates a constant record in the emb_benchmarks section.
+// The linker gathers all records from all files in a table, which Benchmarker iterates.
+// On microcontrollers, the linker script should place this section in flash memory, e.g.:
+//     .emb_benchmarks : {
+//       PROVIDE(__start_emb_benchmarks = .);
+//       KEEP(*(emb_benchmarks))
+//       PROVIDE(__stop_emb_benchmarks = .);
+//     } > FLASH
+EMB_BENCHMARK(Benchmarker, benchmark_empty);
+EMB_BENCHMARK(Benchmarker, benchmark_loop, 1000);
+
+/// A benchmark reporting class, using std::cout and printing everything.
+struct Reporter {
+  template <typename Accumulator>
+  static void report(const char* name, size_t iterations, Accumulator mean, Accumulator sd) {
+    std::cout << name         << '\t'
+              << iterations   << '\t'
+              << mean.count() << "ns\t"
+              << sd.count()   << "ns\n";
+  }
+};
+
+int main() {
+  // No registration needed: the table is built at link time.
+  Benchmarker benchmarker(100000);
+  benchmarker.runBenchmarks<Reporter>();
+}
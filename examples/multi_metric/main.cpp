@@ -0,0 +1,87 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// Benchmark example: 
+//   - Sampling wall time, CPU time and cycles in the same run, with emb::MultiTimer
+//   - Naming the sampled metrics, which are reported as counters with their own statistics
+//   - Telling time spent waiting from time spent computing
+
+//------------------------------------------------------------------------
+// This is free and unencumbered software released into the public domain.
+//
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+//
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to <http://unlicense.org/>
+//------------------------------------------------------------------------
+
+
+
+#include <chrono>
+#include <emb/emb.hpp>
+#include <emb/reporters/console.hpp>
+#include <emb/timers/multi.hpp>
+#include <emb/timers/posix.hpp>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/// CPU time of the benchmark's thread, in nanoseconds
+struct ThreadCpu : emb::ThreadCpuTimer {
+  static const char* name() { return "cpu_ns"; }
+};
+
+#if defined(__x86_64__) || defined(__i386__)
+/// Time stamp counter, in reference cycles
+struct Cycles {
+  static unsigned long long now() { return __rdtsc(); }
+  static const char* name() { return "cycles"; }
+};
+
+/// Wall time for the results, with the thread's CPU time and cycles sampled alongside
+using Timer = emb::MultiTimer<std::chrono::steady_clock, ThreadCpu, Cycles>;
+#else
+using Timer = emb::MultiTimer<std::chrono::steady_clock, ThreadCpu>;
+#endif
+
+using Benchmarker = emb::Benchmarker<Timer>;
+
+/// Only computes: CPU time is about the wall time
+void benchmark_compute(Benchmarker::State& s) {
+  for (auto _ : s)
+    for (int i = 0; i < 10000; i++)
+      emb::dontOptimize(i);
+}
+
+/// Mostly waits: CPU time is much lower than the wall time
+void benchmark_wait(Benchmarker::State& s) {
+  for (auto _ : s)
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+}
+
+int main() {
+  Benchmarker benchmarker(1000);
+  EMB_MAKE_BENCHMARK(benchmarker, benchmark_compute);
+  EMB_MAKE_BENCHMARK(benchmarker, benchmark_wait);
+
+  emb::ConsoleReporter reporter;
+  benchmarker.runBenchmarks(reporter);
+}
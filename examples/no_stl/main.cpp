@@ -0,0 +1,111 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// Benchmark example: 
+//   - Using EMB without the C++ standard library, as in most microcontrollers
+//   - Registering benchmarks without allocating memory, with a fixed capacity
+//   - Registering benchmarks at static initialization time
+
+//------------------------------------------------------------------------
+// This is free and unencumbered software released into the public domain.
+//
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+//
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to <http://unlicense.org/>
+//------------------------------------------------------------------------
+
+
+// Without the STL, we need to provide a declval implementation.
+// As it's only used in unevaluated contexts, a declaration is enough.
+template <typename T>
+T&& declval() noexcept;
+
+#define EMB_NO_STL
+#define EMB_DECLVAL declval
+
+#include <emb/emb.hpp>
+#include <stdio.h>
+#include <time.h>
+
+/// Timer with nanosecond integer ticks.
+/// In a microcontroller, this would read a hardware timer or a cycle counter.
+struct monotonic_timer {
+  static unsigned long long now() {
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1000000000ull + t.tv_nsec;
+  }
+};
+
+/// The Benchmarker we'll use:
+///    - Our monotonic_timer class for providing time
+///    - Double accumulator, for better representation of statistics
+///    - Storage for 4 benchmarks registered with registerBenchmark, without a vector.
+using Benchmarker = emb::Benchmarker<monotonic_timer, double, 4>;
+
+/// Empty loop Benchmark
+void benchmark_empty(Benchmarker::State& s) {
+  for (auto _ : s) {
+  }
+}
+
+/// Simple for loop benchmark
+void benchmark_loop(Benchmarker::State& s) {
+  for (auto _ : s) {
+    for (int i = 0; i < 10000; i++)
+      emb::dontOptimize(i);
+  }
+}
+
+/// Benchmark registered at static initialization time.
+/// It runs on every Benchmarker of the same type, and needs no container.
+void benchmark_static(Benchmarker::State& s) {
+  for (auto _ : s) {
+    for (int i = 0; i < 100; i++)
+      emb::dontOptimize(i);
+  }
+}
+
+EMB_REGISTER_BENCHMARK(Benchmarker, benchmark_static, 500);
+
+/// A benchmark reporting class, using C's printf.
+struct Reporter {
+  static void report(const char* name, size_t iterations, double mean, double sd) {
+    printf("%s\t%zu\t%.1fns\t%.1fns\n", name, iterations, mean, sd);
+  }
+};
+
+/// A table of benchmarks. If it had more than 4 entries, it wouldn't compile.
+const Benchmarker::Descriptor benchmarks[] = {
+    {"benchmark_empty", benchmark_empty, 0},
+    {"benchmark_loop", benchmark_loop, 1000},
+};
+
+int main() {
+  // Register all benchmarks from the table. A 0 iteration count uses the default.
+  Benchmarker benchmarker(benchmarks, 100000);
+
+  // We can still register benchmarks at runtime, as there's space for them.
+  // registerBenchmark returns false if the benchmark doesn't fit.
+  if (!benchmarker.registerBenchmark("benchmark_empty_short", benchmark_empty, 10))
+    return 1;
+
+  benchmarker.runBenchmarks<Reporter>();
+}
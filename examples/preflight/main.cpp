@@ -0,0 +1,67 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// Benchmark example: 
+//   - Checking the host for sources of noise before running benchmarks
+//   - Warning about problems, or refusing to run with --strict
+//   - Recording the findings in the report's context
+
+//------------------------------------------------------------------------
+// This is free and unencumbered software released into the public domain.
+//
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+//
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to <http://unlicense.org/>
+//------------------------------------------------------------------------
+
+
+// Room for the host description, the preflight findings and more
+#define EMB_CONTEXT_SIZE 32
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <emb/emb.hpp>
+#include <emb/host.hpp>
+#include <emb/preflight.hpp>
+#include <emb/reporters/json.hpp>
+
+using Benchmarker = emb::Benchmarker<std::chrono::steady_clock>;
+
+void benchmark_loop(Benchmarker::State& s) {
+  for (auto _ : s)
+    for (int i = 0; i < 100; i++)
+      emb::dontOptimize(i);
+}
+
+int main(int argc, char** argv) {
+  bool strict = argc > 1 && std::strcmp(argv[1], "--strict") == 0;
+
+  Benchmarker benchmarker(1000);
+  EMB_MAKE_BENCHMARK(benchmarker, benchmark_loop);
+  emb::describeHost(benchmarker.context());
+
+  // Problems are printed to stderr. Strict runs don't run benchmarks if there's any.
+  emb::Preflight preflight(strict ? emb::PreflightPolicy::Refuse : emb::PreflightPolicy::Warn);
+  benchmarker.preflight(preflight);
+
+  emb::JsonReporter reporter(stdout);
+  return benchmarker.runBenchmarks(reporter) ? 0 : 1;
+}
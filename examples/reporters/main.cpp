@@ -0,0 +1,110 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// Benchmark example: 
+//   - Using the JSON and CSV reporters shipped with EMB
+//   - Describing the benchmark run with a Context
+//   - Deferring output until all benchmarks finish
+//   - Reporting user-defined counters
+//   - Using results programmatically
+//   - Collecting a combination of statistics
+
+//------------------------------------------------------------------------
+// This is free and unencumbered software released into the public domain.
+//
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+//
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to <http://unlicense.org/>
+//------------------------------------------------------------------------
+
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <emb/emb.hpp>
+#include <emb/host.hpp>
+#include <emb/reporters/csv.hpp>
+#include <emb/reporters/deferred.hpp>
+#include <emb/reporters/json.hpp>
+
+/// The statistics we'll collect: mean and standard deviation, minimum, maximum,
+/// and a histogram of 8 bins of 100ns. All of them are reported.
+using Statistics = emb::statistics::Set<emb::statistics::Welford, emb::statistics::Min,
+    emb::statistics::Max, emb::statistics::Histogram<8, 100>>;
+
+/// The Benchmarker we'll use, as in the stl_chrono example, with our statistics
+using Benchmarker = emb::Benchmarker<std::chrono::steady_clock,
+    std::chrono::duration<double, std::nano>, 0, Statistics>;
+
+/// Empty loop Benchmark
+void benchmark_empty(Benchmarker::State& s) {
+  for (auto _ : s) {
+  }
+}
+
+/// Simple for loop benchmark, with a counter of the items processed in each iteration
+void benchmark_loop(Benchmarker::State& s) {
+  for (auto _ : s) {
+    for (int i = 0; i < 10000; i++)
+      emb::dontOptimize(i);
+  }
+  s.counters().set("items", 10000);
+}
+
+/// Usage: reporters_example [json|csv|deferred|results]
+int main(int argc, char** argv) {
+  Benchmarker benchmarker(10000);
+  EMB_MAKE_BENCHMARK(benchmarker, benchmark_empty);
+  EMB_MAKE_BENCHMARK(benchmarker, benchmark_loop, 1000);
+
+  // The context describes the run, and is given to the reporters' begin function.
+  // We can add host information and our own properties.
+  emb::describeHost(benchmarker.context());
+  benchmarker.context().set("example", "reporters");
+
+  const char* mode = argc > 1 ? argv[1] : "json";
+
+  if (std::strcmp(mode, "csv") == 0) {
+    emb::CsvReporter reporter(stdout);
+    benchmarker.runBenchmarks(reporter);
+  } else if (std::strcmp(mode, "deferred") == 0) {
+    // Results are stored in a table of 16 entries, and only printed at end(),
+    // so writing to the console doesn't affect the following benchmarks.
+    emb::CsvReporter csv(stdout);
+    emb::DeferredReporter<emb::CsvReporter, Benchmarker::Result, 16> reporter(csv);
+    benchmarker.runBenchmarks(reporter);
+  } else if (std::strcmp(mode, "results") == 0) {
+    // Results can also be collected in a container, processed, and reported later.
+    auto results = benchmarker.run();
+    const Benchmarker::Result* fastest = &results.front();
+    for (auto& r : results)
+      if (r.mean < fastest->mean)
+        fastest = &r;
+    // Collected statistics are in timer ticks, and converted like the reported ones
+    auto min = fastest->statistics.get<emb::statistics::Min>().min();
+    auto min_ns = Benchmarker::Conversion::toAccumulator(min).count();
+    std::printf("fastest: %s, min %.1fns\n", fastest->name, min_ns);
+    emb::JsonReporter reporter(stdout);
+    benchmarker.report(results, reporter);
+  } else {
+    emb::JsonReporter reporter(stdout);
+    benchmarker.runBenchmarks(reporter);
+  }
+}
@@ -0,0 +1,89 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// Benchmark example: 
+//   - Monitoring each benchmark run with emb::ResourceUsage
+//   - Peak memory growth and page faults of benchmarks that allocate
+//   - Context switches of benchmarks that block
+
+//------------------------------------------------------------------------
+// This is free and unencumbered software released into the public domain.
+//
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+//
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to <http://unlicense.org/>
+//------------------------------------------------------------------------
+
+
+
+// ResourceUsage adds 5 counters to the up to 6 of the Benchmarker
+#define EMB_COUNTERS_SIZE 12
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <emb/emb.hpp>
+#include <emb/reporters/console.hpp>
+#include <emb/usage.hpp>
+#include <thread>
+#include <vector>
+
+using Benchmarker = emb::Benchmarker<std::chrono::steady_clock>;
+
+/// Keeps a new 1MiB buffer each iteration: the resident set grows, with a fault for each page
+void benchmark_grow(Benchmarker::State& s) {
+  constexpr size_t size = 1 << 20;
+  std::vector<char*> buffers;
+  for (auto _ : s) {
+    char* p = static_cast<char*>(std::malloc(size));
+    std::memset(p, 1, size);
+    buffers.push_back(p);
+  }
+  for (char* p : buffers)
+    std::free(p);
+}
+
+/// Touches the same buffer: it only faults on the first iteration
+void benchmark_reuse(Benchmarker::State& s) {
+  static char buffer[1 << 20];
+  for (auto _ : s) {
+    std::memset(buffer, 1, sizeof(buffer));
+    emb::clobberMemory();
+  }
+}
+
+/// Sleeps: a voluntary context switch per iteration
+void benchmark_sleep(Benchmarker::State& s) {
+  for (auto _ : s)
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+}
+
+int main() {
+  Benchmarker benchmarker(100);
+  EMB_MAKE_BENCHMARK(benchmarker, benchmark_grow);
+  EMB_MAKE_BENCHMARK(benchmarker, benchmark_reuse);
+  EMB_MAKE_BENCHMARK(benchmarker, benchmark_sleep);
+
+  emb::ResourceUsage usage;
+  benchmarker.monitor(usage);
+
+  emb::ConsoleReporter reporter;
+  benchmarker.runBenchmarks(reporter);
+}
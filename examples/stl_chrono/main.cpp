@@ -2,6 +2,7 @@
 // Benchmark example: 
 //   - Creating benchmark functions
 //   - Using std::chrono
+//   - Registering capturing lambdas as benchmarks
 //   - Creating a benchmark reporter class
 //   - Running benchmarks
 
@@ -101,6 +102,18 @@ int main() {
   // 3. Use any of the methods above, but also specifying the number of iterations for each case.
   EMB_MAKE_BENCHMARK(benchmarker, benchmark_loop_double, 12000);
 
+  // 4. Register a lambda that captures its context. It's stored inside the benchmarker, without
+  //    allocating memory, so it must be small: capture big objects by reference.
+  int data[256] = {};
+  benchmarker.registerBenchmark("benchmark_sum", [&data](Benchmarker::State& s) {
+    for (auto _ : s) {
+      int sum = 0;
+      for (int value : data)
+        sum += value;
+      emb::dontOptimize(sum);
+    }
+  });
+
   // To run the benchmarks, we just need to call runBenchmarks with the desired Reporter class.
   benchmarker.runBenchmarks<Reporter>();
 }
\ No newline at end of file
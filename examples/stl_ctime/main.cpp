@@ -37,6 +37,7 @@
 /// Timer using C's clock() function, for CPU Time.
 /// Our return type is a double number with clock() converted to microseconds.
 /// Should present lower variance than std::chrono, but may present lower precision in some platforms.
+/// clock() is process-wide: on POSIX hosts, emb/timers/posix.hpp has per-thread CPU timers.
 struct cpu_timer {
   static double now() {
     std::clock_t cpu_time = std::clock();
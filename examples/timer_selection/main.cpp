@@ -0,0 +1,78 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// Benchmark example: 
+//   - Measuring the resolution, overhead, monotonicity and consistency of timers
+//   - Selecting the best POSIX clock for the benchmarks' granularity at startup
+//   - Reporting the selected clock in the context
+
+//------------------------------------------------------------------------
+// This is free and unencumbered software released into the public domain.
+//
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+//
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to <http://unlicense.org/>
+//------------------------------------------------------------------------
+
+
+
+#include <chrono>
+#include <cstdio>
+#include <emb/emb.hpp>
+#include <emb/reporters/console.hpp>
+#include <emb/timers/select.hpp>
+
+/// Prints a timer's characteristics
+void print(const emb::TimerCharacteristics& t) {
+  std::printf("%-26s %12.1f %12.1f %10s %11s\n", t.name, t.resolution_ns, t.overhead_ns,
+      t.monotonic ? "yes" : "no", t.consistent ? "yes" : "no");
+}
+
+/// Benchmarker reading the selected clock
+using Benchmarker = emb::Benchmarker<emb::SelectedTimer, double>;
+
+void benchmark_loop(Benchmarker::State& s) {
+  for (auto _ : s)
+    for (int i = 0; i < 1000; i++)
+      emb::dontOptimize(i);
+}
+
+int main() {
+  // Any timer may be measured
+  std::printf("%-26s %12s %12s %10s %11s\n", "Timer", "Resolution", "Overhead", "Monotonic",
+      "Consistent");
+  print(emb::characterizeTimer<std::chrono::steady_clock>("std::chrono::steady_clock"));
+  print(emb::characterizeTimer<emb::MonotonicTimer>("emb::MonotonicTimer"));
+#ifdef CLOCK_MONOTONIC_RAW
+  print(emb::characterizeTimer<emb::MonotonicRawTimer>("emb::MonotonicRawTimer"));
+#endif
+  print(emb::characterizeTimer<emb::ThreadCpuTimer>("emb::ThreadCpuTimer"));
+  print(emb::characterizeTimer<emb::ProcessCpuTimer>("emb::ProcessCpuTimer"));
+  std::printf("\n");
+
+  // Iterations of benchmark_loop take about a microsecond.
+  // For long iterations, a coarse clock with a lower overhead may be chosen.
+  Benchmarker benchmarker(10000);
+  emb::selectTimer(1000, benchmarker.context());
+  EMB_MAKE_BENCHMARK(benchmarker, benchmark_loop);
+
+  emb::ConsoleReporter reporter;
+  benchmarker.runBenchmarks(reporter);
+}
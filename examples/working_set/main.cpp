@@ -0,0 +1,91 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// Benchmark example: 
+//   - Giving each iteration a different input buffer, from a pool
+//   - Sweeping the pool's size, from L1-sized to DRAM-sized working sets
+//   - Finding how sensitive a kernel is to the cache level its inputs come from
+
+//------------------------------------------------------------------------
+// This is free and unencumbered software released into the public domain.
+//
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+//
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to <http://unlicense.org/>
+//------------------------------------------------------------------------
+
+
+#include <chrono>
+#include <cstdio>
+#include <emb/emb.hpp>
+#include <emb/inputs.hpp>
+#include <emb/reporters/csv.hpp>
+#include <vector>
+
+using Benchmarker =
+    emb::Benchmarker<std::chrono::steady_clock, std::chrono::duration<double, std::nano>>;
+
+/// Size of each input, a 4KiB block of integers
+constexpr size_t block_bytes = 4096;
+
+/// Working set sizes to sweep, and the benchmark names for them
+constexpr size_t KiB = 1024;
+constexpr size_t MiB = 1024 * KiB;
+const size_t sizes[] = {16 * KiB, 256 * KiB, 4 * MiB, 64 * MiB};
+const char* const names[] = {"sum/16KiB", "sum/256KiB", "sum/4MiB", "sum/64MiB"};
+
+/// The kernel: sums a block
+unsigned sum(const unsigned* block) {
+  unsigned total = 0;
+  for (size_t i = 0; i < block_bytes / sizeof(unsigned); i++)
+    total += block[i];
+  return total;
+}
+
+int main() {
+  // Memory for the largest pool. Smaller pools use its beginning.
+  std::vector<char> memory(64 * MiB);
+
+  // Pools are built and filled before running, outside the timed region
+  std::vector<emb::BufferPool> pools;
+  for (size_t size : sizes) {
+    pools.emplace_back(memory.data(), size, block_bytes);
+    pools.back().fill([](void* buffer, size_t bytes, size_t index) {
+      for (size_t i = 0; i < bytes / sizeof(unsigned); i++)
+        static_cast<unsigned*>(buffer)[i] = static_cast<unsigned>(index + i);
+    });
+  }
+
+  Benchmarker benchmarker(10000);
+  for (size_t i = 0; i < pools.size(); i++) {
+    emb::BufferPool* pool = &pools[i];
+    benchmarker.registerBenchmark(names[i], [pool](Benchmarker::State& s) {
+      for (auto _ : s) {
+        // Each iteration sums the next block of the pool
+        auto block = static_cast<const unsigned*>(s.input(*pool));
+        emb::dontOptimize(sum(block));
+      }
+    });
+  }
+
+  // Results include the "working_set" counter, in bytes
+  emb::CsvReporter reporter(stdout);
+  benchmarker.runBenchmarks(reporter);
+}
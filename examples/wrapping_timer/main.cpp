@@ -0,0 +1,100 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// Benchmark example: 
+//   - Using a narrow, wrapping hardware counter as a timer
+//   - Simulating the counter on a host, to test the code before running it on the target
+//   - Flagging measurements that may have wrapped, and why long ones need an overflow count
+
+//------------------------------------------------------------------------
+// This is free and unencumbered software released into the public domain.
+//
+// Anyone is free to copy, modify, publish, use, compile, sell, or
+// distribute this software, either in source code form or as a compiled
+// binary, for any purpose, commercial or non-commercial, and by any
+// means.
+//
+// In jurisdictions that recognize copyright laws, the author or authors
+// of this software dedicate any and all copyright interest in the
+// software to the public domain. We make this dedication for the benefit
+// of the public at large and to the detriment of our heirs and
+// successors. We intend this dedication to be an overt act of
+// relinquishment in perpetuity of all present and future rights to this
+// software under copyright law.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+// OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+// OTHER DEALINGS IN THE SOFTWARE.
+//
+// For more information, please refer to <http://unlicense.org/>
+//------------------------------------------------------------------------
+
+
+#include <chrono>
+#include <cstdio>
+#include <emb/emb.hpp>
+#include <emb/timers/simulated.hpp>
+#include <emb/timers/wrapping.hpp>
+
+/// A 16-bit counter at 1MHz, wrapping every 65.536ms.
+/// On a target, this would be a struct with a now() function reading the timer register.
+using Counter = emb::SimulatedCounter<16, 1000000>;
+
+/// The same counter, with an overflow count, as kept by an overflow interrupt.
+using OverflowCounter = emb::SimulatedOverflowCounter<16, 1000000>;
+
+/// Benchmarkers using the counters, extended to 64 bits.
+/// The counters' tick period converts the results to microseconds.
+using Microseconds = std::chrono::duration<double, std::micro>;
+using Benchmarker = emb::Benchmarker<emb::WrappingTimer<Counter, 16>, Microseconds>;
+using OverflowBenchmarker = emb::Benchmarker<emb::WrappingTimer<OverflowCounter, 16>, Microseconds>;
+
+/// Busy-waits for a number of milliseconds
+void wait(int milliseconds) {
+  auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(milliseconds);
+  while (std::chrono::steady_clock::now() < end) {
+  }
+}
+
+/// Benchmark shorter than the counter's period, so wraps are handled by the extension
+template <typename B>
+void benchmark_10ms(typename B::State& s) {
+  for (auto _ : s)
+    wait(10);
+}
+
+/// Benchmark longer than the counter's period.
+/// Without an overflow count, these measurements are wrong: only 100ms modulo 65.536ms is seen.
+/// They're reported as ambiguous only because that's over half the range: 70ms would read as
+/// 4.5ms, unflagged.
+template <typename B>
+void benchmark_100ms(typename B::State& s) {
+  for (auto _ : s)
+    wait(100);
+}
+
+/// A benchmark reporting class, showing the ambiguous samples
+struct Reporter {
+  template <typename Result>
+  void report(const Result& r) {
+    auto ambiguous = r.counters.find("ambiguous_samples");
+    std::printf("%s\t%zu\t%.1fus\t%.1fus\t%llu ambiguous\n", r.name, r.iterations,
+        r.mean.count(), r.standard_deviation.count(), ambiguous ? ambiguous->unsigned_value : 0);
+  }
+};
+
+int main() {
+  std::printf("Counter:\n");
+  Benchmarker benchmarker(10);
+  benchmarker.registerBenchmark("benchmark_10ms", benchmark_10ms<Benchmarker>);
+  benchmarker.registerBenchmark("benchmark_100ms", benchmark_100ms<Benchmarker>);
+  benchmarker.runBenchmarks<Reporter>();
+
+  std::printf("Counter with overflow count:\n");
+  OverflowBenchmarker overflow_benchmarker(10);
+  overflow_benchmarker.registerBenchmark("benchmark_10ms", benchmark_10ms<OverflowBenchmarker>);
+  overflow_benchmarker.registerBenchmark("benchmark_100ms", benchmark_100ms<OverflowBenchmarker>);
+  overflow_benchmarker.runBenchmarks<Reporter>();
+}
@@ -0,0 +1,108 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// cache.hpp - Data cache eviction, for cold-cache measurements
+
+// Copyright Joel P. C. Filho 2019 - 2019
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EMB_INCLUDED_CACHE_HPP
+#define EMB_INCLUDED_CACHE_HPP
+
+#include <emb/emb.hpp>
+
+/// Size of a cache line, in bytes, used as the stride for eviction
+#ifndef EMB_CACHE_LINE_SIZE
+#define EMB_CACHE_LINE_SIZE 64
+#endif
+
+namespace emb {
+
+namespace detail {
+
+/// Writes back and invalidates the cache line containing address, if supported
+inline void flushCacheLine(const void* address) noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  asm volatile("clflush (%0)" : : "r"(address) : "memory");
+#elif defined(__aarch64__)
+  asm volatile("dc civac, %0" : : "r"(address) : "memory");
+#else
+  (void)address;
+#endif
+}
+
+/// Waits for cache line flushes to complete
+inline void flushFence() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  asm volatile("mfence" : : : "memory");
+#elif defined(__aarch64__)
+  asm volatile("dsb ish" : : : "memory");
+#endif
+}
+
+}  // namespace detail
+
+/// Evicts data caches, for Benchmarker::coldCache, by:
+///   - streaming through a buffer larger than the last-level cache, reading every line, and/or
+///   - flushing registered ranges, such as a benchmark's working set, line by line.
+/// Flushing is supported on x86 and AArch64. Elsewhere (e.g. Cortex-M7 with CMSIS's
+/// SCB_CleanInvalidateDCache), any class with an evict() function may be used instead.
+/// \tparam Ranges  maximum number of registered ranges
+template <size_t Ranges = 8>
+class CacheEvictor {
+ public:
+  /// Whether flushing ranges is supported on this architecture
+  static constexpr bool can_flush =
+#if defined(__x86_64__) || defined(__i386__) || defined(__aarch64__)
+      true;
+#else
+      false;
+#endif
+
+  /// Evicts only registered ranges
+  CacheEvictor() noexcept = default;
+
+  /// Evicts by streaming through buffer, of size bytes, and registered ranges.
+  /// On hosts, a buffer of twice emb::lastLevelCacheSize() (from emb/host.hpp) is a good choice.
+  CacheEvictor(const void* buffer, size_t size) noexcept
+      : buffer_{static_cast<const volatile char*>(buffer)}, buffer_size_{size} {}
+
+  /// Registers a range to flush before each iteration.
+  /// Returns false if there's no space left, or flushing isn't supported.
+  bool add(const void* data, size_t size) noexcept {
+    if (!can_flush || ranges_ == Ranges)
+      return false;
+    range_data_[ranges_] = static_cast<const char*>(data);
+    range_size_[ranges_] = size;
+    ranges_++;
+    return true;
+  }
+
+  /// Evicts the caches
+  void evict() noexcept {
+    for (size_t r = 0; r < ranges_; r++) {
+      for (size_t i = 0; i < range_size_[r]; i += EMB_CACHE_LINE_SIZE)
+        detail::flushCacheLine(range_data_[r] + i);
+      // The range may end in a line the stride skipped, if it isn't aligned
+      if (range_size_[r])
+        detail::flushCacheLine(range_data_[r] + range_size_[r] - 1);
+    }
+    if (ranges_)
+      detail::flushFence();
+
+    char sink = 0;
+    for (size_t i = 0; i < buffer_size_; i += EMB_CACHE_LINE_SIZE)
+      sink ^= buffer_[i];
+    dontOptimize(sink);
+  }
+
+ private:
+  const volatile char* buffer_{nullptr};
+  size_t buffer_size_{0};
+  const char* range_data_[Ranges]{};
+  size_t range_size_[Ranges]{};
+  size_t ranges_{0};
+};
+
+}  // namespace emb
+
+#endif
@@ -28,102 +28,1610 @@
 
 #endif  // EMB_NO_STL
 
+// Size, in bytes, of the inline storage for callables registered as benchmarks.
+// Callables larger than this are rejected at compile time. No heap allocation is performed.
+// Every registered benchmark, including function pointers, holds this storage plus a pointer, so
+// each Benchmarker slot costs about EMB_CALLABLE_SIZE + 4 pointers of RAM.
+// Define it as 0 when only function pointers are registered, to remove that storage.
+#ifndef EMB_CALLABLE_SIZE
+#define EMB_CALLABLE_SIZE (4 * sizeof(void*))
+#endif
+
+// Maximum number of entries in a benchmark Context.
+#ifndef EMB_CONTEXT_SIZE
+#define EMB_CONTEXT_SIZE 16
+#endif
+
+// Maximum number of counters per benchmark result, including those the Benchmarker adds: up to
+// 6 (see emb::detail::library_counters), plus those of timers and monitors.
+#ifndef EMB_COUNTERS_SIZE
+#define EMB_COUNTERS_SIZE 8
+#endif
+
 /// Always inline attribute, compatible with GCC
 #define EMB_ALWAYS_INLINE __attribute__((always_inline))
 
-/// Helper Macro: Register a benchmark with name equal to the function's name
-#define EMB_MAKE_BENCHMARK(benchmarker, function, ...) \
-  benchmarker.registerBenchmark(#function, function, ##__VA_ARGS__);
+/// Helper Macro: Register a benchmark with name equal to the function's name
+#define EMB_MAKE_BENCHMARK(benchmarker, function, ...) \
+  benchmarker.registerBenchmark(#function, function, ##__VA_ARGS__);
+
+/// Helper Macro: Register a benchmark function to every Benchmarker of a type, at static
+/// initialization time, with name equal to the function's name. Uses no memory besides a static
+/// list node, so it doesn't need EMB_VECTOR. Must be used at namespace scope.
+#define EMB_REGISTER_BENCHMARK(benchmarker_type, function, ...)                    \
+  static benchmarker_type::Registration EMB_DETAIL_CONCAT(emb_registration_, __COUNTER__){ \
+      #function, function, ##__VA_ARGS__}
+
+#define EMB_DETAIL_CONCAT_IMPL(a, b) a##b
+#define EMB_DETAIL_CONCAT(a, b) EMB_DETAIL_CONCAT_IMPL(a, b)
+#define EMB_DETAIL_STRINGIFY_IMPL(a) #a
+#define EMB_DETAIL_STRINGIFY(a) EMB_DETAIL_STRINGIFY_IMPL(a)
+
+// Linker section for benchmark tables created with EMB_BENCHMARK, supported on ELF targets.
+// The linker provides __start_ and __stop_ symbols for it, which GNU ld does automatically.
+// Custom linker scripts should KEEP the section, in ROM, and define those symbols.
+// You may set EMB_NO_SECTIONS to disable it, or EMB_SECTION to another C identifier.
+#if defined(__ELF__) && !defined(EMB_NO_SECTIONS)
+#ifndef EMB_SECTION
+#define EMB_SECTION emb_benchmarks
+#endif
+
+#if defined(__has_attribute)
+#if __has_attribute(retain)
+#define EMB_DETAIL_RETAIN , retain
+#endif
+#endif
+#ifndef EMB_DETAIL_RETAIN
+#define EMB_DETAIL_RETAIN
+#endif
+
+#define EMB_DETAIL_SECTION_START EMB_DETAIL_CONCAT(__start_, EMB_SECTION)
+#define EMB_DETAIL_SECTION_STOP EMB_DETAIL_CONCAT(__stop_, EMB_SECTION)
+
+/// Helper Macro: Place a benchmark function in a constant table in the EMB_SECTION linker section,
+/// with name equal to the function's name. Costs no RAM and no initialization time.
+/// Benchmarks run on every Benchmarker of the type, in an unspecified order.
+/// The explicit alignment keeps the compiler from padding entries, so they form an array.
+/// Must be used at namespace scope.
+#define EMB_BENCHMARK(benchmarker_type, function, ...)                                    \
+  static const benchmarker_type::SectionEntry EMB_DETAIL_CONCAT(                         \
+      emb_section_entry_, __COUNTER__)                                                    \
+      __attribute__((section(EMB_DETAIL_STRINGIFY(EMB_SECTION)), used EMB_DETAIL_RETAIN,  \
+          aligned(alignof(benchmarker_type::SectionEntry)))) = {                          \
+          &benchmarker_type::SectionEntry::tag, {#function, function, size_t{__VA_ARGS__}}}
+
+// Bounds of the section, provided by the linker. Weak, so they're null without any EMB_BENCHMARK.
+extern "C" {
+extern const char EMB_DETAIL_SECTION_START[] __attribute__((weak));
+extern const char EMB_DETAIL_SECTION_STOP[] __attribute__((weak));
+}
+#endif  // __ELF__ && !EMB_NO_SECTIONS
+
+/// Embedded MicroBenchmarks namespace
+namespace emb {
+
+/// Prevents a variable from being optimized out by the compiler
+/// The dontOptimize and clobberMemory functions are based on Google Benchmark's
+///  DoNotOptimize and ClobberMemory functions, released under the Apache 2.0 License.
+/// Refer to https://github.com/google/benchmark for details on the library and
+///  http://www.apache.org/licenses/LICENSE-2.0 for the license.
+/// Then, if you find out I can't use them this way, tell me. I have no idea how to do it correctly.
+template <typename T>
+inline EMB_ALWAYS_INLINE void dontOptimize(T& data) {
+  asm volatile("" : "+m,r"(data) : : "memory");
+}
+
+template <typename T>
+inline EMB_ALWAYS_INLINE void dontOptimize(const T& data) {
+  asm volatile("" : : "r,m"(data) : "memory");
+}
+
+/// Creates a memory barrier for reads/writes
+inline EMB_ALWAYS_INLINE void clobberMemory() {
+  asm volatile("" : : : "memory");
+}
+
+/// EMB Implementation details.
+namespace detail {
+/// Tag type for EMB's placement new, so <new> isn't required on platforms without STL.
+struct PlacementTag {};
+}  // namespace detail
+}  // namespace emb
+
+inline void* operator new(size_t, emb::detail::PlacementTag, void* p) noexcept {
+  return p;
+}
+
+inline void operator delete(void*, emb::detail::PlacementTag, void*) noexcept {}
+
+namespace emb {
+namespace detail {
+/// Minimal type traits, as <type_traits> may not be available
+template <bool Condition, typename T = void>
+struct enable_if {};
+
+template <typename T>
+struct enable_if<true, T> {
+  using type = T;
+};
+
+template <typename T>
+struct remove_cvref {
+  using type = T;
+};
+
+template <typename T>
+struct remove_cvref<T&> : remove_cvref<T> {};
+
+template <typename T>
+struct remove_cvref<T&&> : remove_cvref<T> {};
+
+template <typename T>
+struct remove_cvref<const T> : remove_cvref<T> {};
+
+template <typename T>
+struct remove_cvref<volatile T> : remove_cvref<T> {};
+
+template <typename T>
+struct remove_cvref<const volatile T> : remove_cvref<T> {};
+
+template <typename T, typename U>
+struct is_same {
+  static constexpr bool value = false;
+};
+
+template <typename T>
+struct is_same<T, T> {
+  static constexpr bool value = true;
+};
+
+/// Selects True or False, according to Condition
+template <bool Condition, typename True, typename False>
+struct conditional {
+  using type = True;
+};
+
+template <typename True, typename False>
+struct conditional<false, True, False> {
+  using type = False;
+};
+
+/// Checks if T is a built-in integer type
+template <typename T>
+struct is_integer {
+  static constexpr bool value = false;
+};
+
+#define EMB_DETAIL_INTEGER(type)             \
+  template <>                                \
+  struct is_integer<type> {                  \
+    static constexpr bool value = true;      \
+  }
+
+EMB_DETAIL_INTEGER(char);
+EMB_DETAIL_INTEGER(signed char);
+EMB_DETAIL_INTEGER(unsigned char);
+EMB_DETAIL_INTEGER(short);
+EMB_DETAIL_INTEGER(unsigned short);
+EMB_DETAIL_INTEGER(int);
+EMB_DETAIL_INTEGER(unsigned);
+EMB_DETAIL_INTEGER(long);
+EMB_DETAIL_INTEGER(unsigned long);
+EMB_DETAIL_INTEGER(long long);
+EMB_DETAIL_INTEGER(unsigned long long);
+
+#undef EMB_DETAIL_INTEGER
+
+/// Checks if From is implicitly convertible to To
+template <typename From, typename To>
+struct is_convertible {
+ private:
+  static char test(To);
+  static long test(...);
+
+ public:
+  static constexpr bool value = sizeof(test(EMB_DECLVAL<From>())) == sizeof(char);
+};
+
+/// Type-erased callable, stored inline, with a fixed maximum size.
+/// Copyable, so it can be stored in EMB_VECTOR implementations.
+template <typename Argument, size_t Size>
+class InlineCallable {
+  /// Operations for a stored callable type
+  struct Operations {
+    void (*invoke)(void* storage, Argument argument);
+    void (*copy)(void* destination, const void* source);
+    void (*destroy)(void* storage);
+  };
+
+  /// Operations table for a callable type
+  template <typename Callable>
+  struct OperationsFor {
+    static void invoke(void* storage, Argument argument) {
+      (*static_cast<Callable*>(storage))(argument);
+    }
+    static void copy(void* destination, const void* source) {
+      new (PlacementTag{}, destination) Callable(*static_cast<const Callable*>(source));
+    }
+    static void destroy(void* storage) { static_cast<Callable*>(storage)->~Callable(); }
+
+    static constexpr Operations table{&invoke, &copy, &destroy};
+  };
+
+  /// Storage for the callable, aligned for pointers and 64-bit scalars.
+  /// long double is left out, as it would raise the alignment to 16 bytes on some targets.
+  union Storage {
+    unsigned char bytes[Size];
+    void* pointer;
+    void (*function)();
+    long long integer;
+    double real;
+  };
+
+ public:
+  InlineCallable() noexcept = default;
+
+  template <typename F, typename Callable = typename remove_cvref<F>::type,
+      typename enable_if<!is_same<Callable, InlineCallable>::value>::type* = nullptr>
+  explicit InlineCallable(F&& f) : operations_{&OperationsFor<Callable>::table} {
+    static_assert(sizeof(Callable) <= Size,
+        "Callable is larger than EMB_CALLABLE_SIZE. Capture by reference or increase it.");
+    static_assert(alignof(Callable) <= alignof(Storage), "Callable alignment is not supported.");
+    new (PlacementTag{}, &storage_) Callable(static_cast<F&&>(f));
+  }
+
+  InlineCallable(const InlineCallable& other) : operations_{other.operations_} {
+    if (operations_)
+      operations_->copy(&storage_, &other.storage_);
+  }
+
+  InlineCallable& operator=(const InlineCallable& other) {
+    if (this != &other) {
+      reset();
+      if (other.operations_)
+        other.operations_->copy(&storage_, &other.storage_);
+      operations_ = other.operations_;
+    }
+    return *this;
+  }
+
+  ~InlineCallable() { reset(); }
+
+  /// Whether a callable is stored
+  explicit operator bool() const noexcept { return operations_ != nullptr; }
+
+  /// Calls the stored callable. Must not be empty.
+  void operator()(Argument argument) { operations_->invoke(&storage_, argument); }
+
+ private:
+  void reset() noexcept {
+    if (operations_)
+      operations_->destroy(&storage_);
+    operations_ = nullptr;
+  }
+
+  const Operations* operations_{nullptr};
+  Storage storage_;
+};
+
+template <typename Argument, size_t Size>
+template <typename Callable>
+constexpr typename InlineCallable<Argument, Size>::Operations
+    InlineCallable<Argument, Size>::OperationsFor<Callable>::table;
+
+/// Without inline storage, no callable can be stored: only function pointers are registered.
+template <typename Argument>
+class InlineCallable<Argument, 0> {
+ public:
+  InlineCallable() noexcept = default;
+
+  template <typename F, typename Callable = typename remove_cvref<F>::type,
+      typename enable_if<!is_same<Callable, InlineCallable>::value>::type* = nullptr>
+  explicit InlineCallable(F&&) {
+    static_assert(sizeof(Callable) == 0, "EMB_CALLABLE_SIZE is 0. Register a function pointer.");
+  }
+
+  /// Whether a callable is stored
+  explicit operator bool() const noexcept { return false; }
+
+  /// Never called, as no callable can be stored
+  void operator()(Argument) noexcept {}
+};
+
+/// Dependent false value, for static_assert in templates that must not be instantiated
+template <typename T>
+struct always_false {
+  static constexpr bool value = false;
+};
+
+}  // namespace detail
+
+/// Vector-like container with a fixed capacity, stored inline
+template <typename T, size_t Capacity>
+class FixedVector {
+ public:
+  /// Appends an element. Returns false, without inserting, if the vector is full.
+  bool push_back(const T& value) {
+    if (size_ == Capacity)
+      return false;
+    data_[size_++] = value;
+    return true;
+  }
+
+  T* begin() noexcept { return data_; }
+  T* end() noexcept { return data_ + size_; }
+  const T* begin() const noexcept { return data_; }
+  const T* end() const noexcept { return data_ + size_; }
+  T& operator[](size_t i) noexcept { return data_[i]; }
+  const T& operator[](size_t i) const noexcept { return data_[i]; }
+  size_t size() const noexcept { return size_; }
+
+ private:
+  T data_[Capacity];
+  size_t size_{0};
+};
+
+namespace detail {
+
+/// Placeholder container, for when there's neither EMB_VECTOR nor a fixed capacity.
+/// Benchmarks may still be registered with EMB_REGISTER_BENCHMARK.
+template <typename T>
+class EmptyVector {
+ public:
+  template <typename U = T>
+  bool push_back(const U&) {
+    static_assert(always_false<U>::value,
+        "registerBenchmark requires EMB_VECTOR or a Benchmarker with a fixed Capacity.");
+    return false;
+  }
+
+  T* begin() noexcept { return nullptr; }
+  T* end() noexcept { return nullptr; }
+};
+
+/// Selects the container storing registered benchmarks
+template <typename T, size_t Capacity>
+struct registry {
+  using type = FixedVector<T, Capacity>;
+};
+
+template <typename T>
+struct registry<T, 0> {
+#ifdef EMB_VECTOR
+  using type = EMB_VECTOR<T>;
+#else
+  using type = EmptyVector<T>;
+#endif
+};
+
+/// Appends to a registry container, returning whether it was inserted
+template <typename Container, typename T>
+inline auto append(Container& c, const T& value) -> decltype(c.push_back(value), true) {
+  c.push_back(value);
+  return true;
+}
+
+template <typename T, size_t Capacity>
+inline bool append(FixedVector<T, Capacity>& c, const T& value) {
+  return c.push_back(value);
+}
+
+/// Determines the time point type for a timer class
+template <typename Timer>
+using default_time_point_t = decltype(Timer::now());
+
+/// Determines the duration type for a time point type
+template <typename TimePoint>
+using duration_t = decltype(EMB_DECLVAL<TimePoint>() - EMB_DECLVAL<TimePoint>());
+
+/// Determines the default duration type for a timer class, using the default time point.
+template <typename Timer>
+using default_duration_t = duration_t<default_time_point_t<Timer>>;
+
+/// Basic multiplication for accumulators
+template <typename Accumulator>
+inline auto multiply(const Accumulator& a1, const Accumulator& a2) -> decltype(a1 * a2) {
+  return a1 * a2;
+}
+
+/// Multiplication for std::chrono-like accumulator types, where operator * is not defined,
+/// but a .count() member function is provided
+template <typename Accumulator, decltype(EMB_DECLVAL<Accumulator>().count())* = nullptr>
+inline Accumulator multiply(const Accumulator& a1, const Accumulator& a2) {
+  return Accumulator(a1.count() * a2.count());
+}
+
+/// Default square root function
+template <typename Accumulator>
+inline auto sqrt(const Accumulator& a) -> decltype(::sqrt(a)) {
+  return ::sqrt(a);
+}
+
+/// Square root function for std::chrono-like types
+template <typename Accumulator>
+inline auto sqrt(const Accumulator& a) -> decltype(::sqrt(a.count())) {
+  return ::sqrt(a.count());
+}
+
+/// Square root function for types providing their own, e.g. fixed-point numbers
+template <typename Accumulator>
+inline auto sqrt(const Accumulator& a) -> decltype(a.sqrt()) {
+  return a.sqrt();
+}
+
+/// Numeric value of a statistic, for std::chrono-like types
+template <typename T>
+inline auto count(const T& value, int) -> decltype(value.count()) {
+  return value.count();
+}
+
+/// Numeric value of a statistic, for basic types
+template <typename T>
+inline T count(const T& value, long) {
+  return value;
+}
+
+/// Numeric value of a statistic
+template <typename T>
+inline auto count(const T& value) -> decltype(count(value, 0)) {
+  return count(value, 0);
+}
+
+/// Widest signed integer type available, for sums that must not overflow
+#ifdef __SIZEOF_INT128__
+__extension__ typedef __int128 wide_int;
+#else
+typedef long long wide_int;
+#endif
+
+/// Conversion to an accumulator, for types constructible from the value
+template <typename Accumulator, typename T>
+inline auto convert(const T& value, int) -> decltype(Accumulator(value)) {
+  return Accumulator(value);
+}
+
+/// Conversion to an accumulator through its count type, e.g. std::chrono integer durations
+template <typename Accumulator, typename T>
+inline Accumulator convert(const T& value, long) {
+  return Accumulator(static_cast<decltype(count(EMB_DECLVAL<Accumulator>()))>(value));
+}
+
+/// Conversion to an accumulator
+template <typename Accumulator, typename T>
+inline Accumulator convert(const T& value) {
+  return convert<Accumulator>(value, 0);
+}
+
+/// Ratio of two integers as an accumulator, for types providing fromRatio
+template <typename Accumulator>
+inline auto ratio(wide_int num, wide_int den, int) -> decltype(Accumulator::fromRatio(num, den)) {
+  return Accumulator::fromRatio(num, den);
+}
+
+/// Ratio of two integers as an accumulator, divided in its count type
+template <typename Accumulator>
+inline Accumulator ratio(wide_int num, wide_int den, long) {
+  using Rep = decltype(count(EMB_DECLVAL<Accumulator>()));
+  return convert<Accumulator>(static_cast<Rep>(num) / static_cast<Rep>(den));
+}
+
+/// Ratio of two integers as an accumulator
+template <typename Accumulator>
+inline Accumulator ratio(wide_int num, wide_int den) {
+  return ratio<Accumulator>(num, den, 0);
+}
+
+/// Integer square root of a non-negative value, rounded down
+template <typename T>
+inline T isqrt(T value) noexcept {
+  T root = 0;
+  T bit = T(1) << (sizeof(T) * 8 - 2);
+  while (bit > value)
+    bit >>= 2;
+  while (bit) {
+    if (value >= root + bit) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return root;
+}
+
+/// Writes prefix followed by the decimal index into buffer, truncating to size
+inline void indexedName(char* buffer, size_t size, const char* prefix, unsigned long long index) {
+  char digits[20];
+  size_t n = 0;
+  do {
+    digits[n++] = static_cast<char>('0' + index % 10);
+    index /= 10;
+  } while (index);
+  size_t i = 0;
+  while (*prefix && i + 1 < size)
+    buffer[i++] = *prefix++;
+  while (n && i + 1 < size)
+    buffer[i++] = digits[--n];
+  buffer[i] = '\0';
+}
+
+/// Period of a std::chrono-like type, in seconds, as num / den. 0 / 0 if T has no period.
+template <typename T, typename = void>
+struct period {
+  static constexpr long long num = 0;
+  static constexpr long long den = 0;
+};
+
+template <typename T>
+struct period<T, decltype(void(T::period::num))> {
+  static constexpr long long num = T::period::num;
+  static constexpr long long den = T::period::den;
+};
+
+/// Exposes Counter::period, if provided, for timers reading another timer or counter
+template <typename Counter, typename = void>
+struct counter_period {};
+
+template <typename Counter>
+struct counter_period<Counter, decltype(void(Counter::period::num))> {
+  using period = typename Counter::period;
+};
+
+/// Greatest common divisor, for reducing ratios at compile time
+constexpr long long gcd(long long a, long long b) {
+  return b ? gcd(b, a % b) : a;
+}
+
+/// Mixes the bits of a 64-bit value (SplitMix64's finalizer)
+inline unsigned long long mix(unsigned long long z) noexcept {
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+/// Position of index in a pseudo-random permutation of [0, n), keyed by key, without storage:
+/// a Feistel network over the next power of four, repeated until the result is below n.
+inline size_t permute(size_t index, size_t n, unsigned long long key) noexcept {
+  unsigned half = 1;
+  while ((1ULL << (2 * half)) < n)
+    half++;
+  const unsigned long long mask = (1ULL << half) - 1;
+  unsigned long long x = index;
+  do {
+    unsigned long long left = x >> half;
+    unsigned long long right = x & mask;
+    for (unsigned long long round = 0; round < 4; round++) {
+      unsigned long long next = left ^ (mix(right + key + round * 0x9E3779B97F4A7C15ULL) & mask);
+      left = right;
+      right = next;
+    }
+    x = (left << half) | right;
+  } while (x >= n);
+  return static_cast<size_t>(x);
+}
+
+/// Conversion of iteration times from timer ticks, as collected, to the accumulator's units.
+/// Ticks are kept in the accumulator's count type, without scaling, and multiplied by the ratio
+/// of the tick period (Timer::period, if provided) to the accumulator's period only when
+/// computing results. If either period is unknown, ticks are the accumulator's units.
+/// Collectors of integers, like IntegerMoments, get the ticks as integers, even for class types
+/// such as emb::Fixed.
+template <typename Timer, typename Accumulator>
+struct TickConversion {
+  /// Type of the values collected in the measurement loop
+  using sample = decltype(count(EMB_DECLVAL<Accumulator>()));
+
+ private:
+  using ticks = typename conditional<period<Timer>::den != 0, Timer,
+      default_duration_t<Timer>>::type;
+  static constexpr bool known = period<ticks>::den != 0 && period<Accumulator>::num != 0;
+  static constexpr long long num_ = known ? period<ticks>::num * period<Accumulator>::den : 1;
+  static constexpr long long den_ = known ? period<ticks>::den * period<Accumulator>::num : 1;
+
+ public:
+  static constexpr long long num = num_ / gcd(num_, den_);
+  static constexpr long long den = den_ / gcd(num_, den_);
+
+  /// Sample of a timer duration: only converts the representation
+  static sample fromTicks(const default_duration_t<Timer>& d) noexcept {
+    return convert<sample>(count(d));
+  }
+
+  /// Time in the accumulator's units
+  static Accumulator toAccumulator(const sample& s) noexcept {
+    return convert<Accumulator>(
+        num == den ? s : s * static_cast<sample>(num) / static_cast<sample>(den));
+  }
+};
+
+/// Conversion for results whose statistics are already in accumulator units
+template <typename Accumulator>
+struct IdentityConversion {
+  using sample = Accumulator;
+
+  static Accumulator toAccumulator(const Accumulator& a) noexcept { return a; }
+};
+
+/// Updates a collector with an iteration's duration. Collectors providing updateTicks, such as
+/// IntegerMoments, get its raw integer ticks, without converting them to the sample type.
+template <typename Conversion, typename Collector, typename Duration>
+inline auto updateCollector(Collector& collector, const Duration& d, size_t n, int) noexcept
+    -> decltype(collector.updateTicks(0LL, n), void()) {
+  collector.updateTicks(static_cast<long long>(count(d)), n);
+}
+
+template <typename Conversion, typename Collector, typename Duration>
+inline void updateCollector(Collector& collector, const Duration& d, size_t n, long) noexcept {
+  collector.update(Conversion::fromTicks(d), n);
+}
+
+/// Updates statistics with an iteration's duration. Collectors of several policies, such as
+/// statistics::Set's, provide updateDuration, to update each policy's collector as it requires.
+template <typename Conversion, typename Collector, typename Duration>
+inline auto updateStatistics(Collector& collector, const Duration& d, size_t n, int) noexcept
+    -> decltype(collector.template updateDuration<Conversion>(d, n), void()) {
+  collector.template updateDuration<Conversion>(d, n);
+}
+
+template <typename Conversion, typename Collector, typename Duration>
+inline void updateStatistics(Collector& collector, const Duration& d, size_t n, long) noexcept {
+  updateCollector<Conversion>(collector, d, n, 0);
+}
+
+/// Calls f(name, value), converting samples to accumulator units
+template <typename Conversion, typename F>
+struct ConvertingVisitor {
+  F& f;
+
+  void operator()(const char* name, const typename Conversion::sample& value) {
+    f(name, Conversion::toAccumulator(value));
+  }
+
+  template <typename T>
+  void operator()(const char* name, const T& value) {
+    f(name, value);
+  }
+};
+
+/// String comparison, as <cstring> may not be available
+inline bool equal(const char* s1, const char* s2) noexcept {
+  while (*s1 && *s1 == *s2) {
+    s1++;
+    s2++;
+  }
+  return *s1 == *s2;
+}
+
+/// 64-bit FNV-1a hash of a string, stable across platforms and runs
+inline unsigned long long fnv1a(const char* s) noexcept {
+  unsigned long long hash = 0xCBF29CE484222325ULL;
+  for (; *s; s++) {
+    hash ^= static_cast<unsigned char>(*s);
+    hash *= 0x100000001B3ULL;
+  }
+  return hash;
+}
+
+/// Whether a name matches a glob pattern, where '*' matches any sequence and '?' any character
+inline bool matches(const char* pattern, const char* name) noexcept {
+  const char* star = nullptr;
+  const char* retry = nullptr;
+  while (*name) {
+    if (*pattern == '*') {
+      star = ++pattern;
+      retry = name;
+    } else if (*pattern == '?' || *pattern == *name) {
+      pattern++;
+      name++;
+    } else if (star) {
+      pattern = star;
+      name = ++retry;
+    } else {
+      return false;
+    }
+  }
+  while (*pattern == '*')
+    pattern++;
+  return *pattern == '\0';
+}
+
+/// Calls Reporter::report with a Result, if supported
+template <typename Reporter, typename Result>
+inline auto report(Reporter& reporter, const Result& result, int)
+    -> decltype(reporter.report(result), void()) {
+  reporter.report(result);
+}
+
+/// Calls Reporter::report(name, iterations, mean, standard_deviation), otherwise
+template <typename Reporter, typename Result>
+inline void report(Reporter& reporter, const Result& result, long) {
+  reporter.report(result.name, result.iterations, result.mean, result.standard_deviation);
+}
+
+/// Reading at the start of a measurement: Timer::start(), if provided, or Timer::now().
+/// Timers reading several clocks provide start() and stop() to nest their readings.
+template <typename Timer>
+inline auto startReading(int) -> decltype(Timer::start()) {
+  return Timer::start();
+}
+
+template <typename Timer>
+inline auto startReading(long) -> decltype(Timer::now()) {
+  return Timer::now();
+}
+
+/// Reading at the end of a measurement: Timer::stop(), if provided, or Timer::now()
+template <typename Timer>
+inline auto stopReading(int) -> decltype(Timer::stop()) {
+  return Timer::stop();
+}
+
+template <typename Timer>
+inline auto stopReading(long) -> decltype(Timer::now()) {
+  return Timer::now();
+}
+
+/// Number of ambiguous timer readings since the last call, if the Timer tracks them
+template <typename Timer>
+inline auto takeAmbiguous(int) -> decltype(static_cast<size_t>(Timer::takeAmbiguous())) {
+  return static_cast<size_t>(Timer::takeAmbiguous());
+}
+
+template <typename Timer>
+inline size_t takeAmbiguous(long) {
+  return 0;
+}
+
+/// Adds the counters collected by the Timer since the last call, e.g. CPU time, if it has any
+template <typename Timer, typename Counters>
+inline auto takeCounters(Counters& counters, int)
+    -> decltype(Timer::takeCounters(counters), void()) {
+  Timer::takeCounters(counters);
+}
+
+template <typename Timer, typename Counters>
+inline void takeCounters(Counters&, long) {}
+
+/// Calls Reporter::begin(context), if provided
+template <typename Reporter, typename Context>
+inline auto begin(Reporter& reporter, const Context& context, int)
+    -> decltype(reporter.begin(context), void()) {
+  reporter.begin(context);
+}
+
+template <typename Reporter, typename Context>
+inline void begin(Reporter&, const Context&, long) {}
+
+/// Calls Reporter::end(), if provided
+template <typename Reporter>
+inline auto end(Reporter& reporter, int) -> decltype(reporter.end(), void()) {
+  reporter.end();
+}
+
+template <typename Reporter>
+inline void end(Reporter&, long) {}
+
+/// Hook calling Source::describe(counters) through a void*, if provided, or nullptr
+template <typename Counters, typename Source>
+inline auto describeHook(Source&, int) -> decltype(EMB_DECLVAL<Source&>().describe(
+    EMB_DECLVAL<Counters&>()), static_cast<void (*)(void*, Counters&)>(nullptr)) {
+  return [](void* source, Counters& counters) {
+    static_cast<Source*>(source)->describe(counters);
+  };
+}
+
+template <typename Counters, typename Source>
+inline auto describeHook(Source&, long) -> void (*)(void*, Counters&) {
+  return nullptr;
+}
+
+/// Hook calling Source::prepare() through a void*, if provided, or nullptr
+template <typename Source>
+inline auto prepareHook(Source&, int)
+    -> decltype(EMB_DECLVAL<Source&>().prepare(), static_cast<void (*)(void*)>(nullptr)) {
+  return [](void* source) { static_cast<Source*>(source)->prepare(); };
+}
+
+template <typename Source>
+inline auto prepareHook(Source&, long) -> void (*)(void*) {
+  return nullptr;
+}
+
+}  // namespace detail
+
+/// A named value, describing a benchmark run
+struct Property {
+  /// Type of the stored value
+  enum class Type : unsigned char { String, Signed, Unsigned, Real };
+
+  /// Name of the property
+  const char* key;
+  /// Type of the stored value
+  Type type;
+  /// Value, according to type
+  union {
+    const char* string;
+    long long signed_value;
+    unsigned long long unsigned_value;
+    double real;
+  };
+};
+
+/// A fixed-capacity collection of properties, stored inline.
+/// Keys and string values are not copied, and must outlive the collection.
+/// Properties that don't fit are counted, in an extra "dropped_properties" property.
+template <size_t Capacity>
+class Properties {
+ public:
+  /// Set a property, replacing any value with the same key.
+  /// Returns false if there's no space left.
+  bool set(const char* key, const char* value) noexcept {
+    Property* p = slot(key);
+    if (!p)
+      return false;
+    p->type = Property::Type::String;
+    p->string = value;
+    return true;
+  }
+
+  bool set(const char* key, long long value) noexcept {
+    Property* p = slot(key);
+    if (!p)
+      return false;
+    p->type = Property::Type::Signed;
+    p->signed_value = value;
+    return true;
+  }
+
+  bool set(const char* key, unsigned long long value) noexcept {
+    Property* p = slot(key);
+    if (!p)
+      return false;
+    p->type = Property::Type::Unsigned;
+    p->unsigned_value = value;
+    return true;
+  }
+
+  bool set(const char* key, double value) noexcept {
+    Property* p = slot(key);
+    if (!p)
+      return false;
+    p->type = Property::Type::Real;
+    p->real = value;
+    return true;
+  }
+
+  bool set(const char* key, int value) noexcept { return set(key, static_cast<long long>(value)); }
+  bool set(const char* key, long value) noexcept { return set(key, static_cast<long long>(value)); }
+  bool set(const char* key, unsigned value) noexcept {
+    return set(key, static_cast<unsigned long long>(value));
+  }
+  bool set(const char* key, unsigned long value) noexcept {
+    return set(key, static_cast<unsigned long long>(value));
+  }
+  bool set(const char* key, float value) noexcept { return set(key, static_cast<double>(value)); }
+
+  /// Set a copy of another property, e.g. from another collection
+  bool set(const Property& property) noexcept {
+    Property* p = slot(property.key);
+    if (!p)
+      return false;
+    *p = property;
+    return true;
+  }
+
+  /// Find a property by key. Returns nullptr if not found.
+  const Property* find(const char* key) const noexcept {
+    for (auto& p : *this)
+      if (detail::equal(p.key, key))
+        return &p;
+    return nullptr;
+  }
+
+  const Property* begin() const noexcept { return properties_; }
+  const Property* end() const noexcept { return properties_ + size(); }
+  /// Number of properties, including "dropped_properties" if any was dropped
+  size_t size() const noexcept { return dropped_ ? size_ + 1 : size_; }
+
+  /// Maximum number of properties, besides "dropped_properties"
+  static constexpr size_t capacity() noexcept { return Capacity; }
+
+  /// Number of values set that didn't fit
+  size_t dropped() const noexcept { return dropped_; }
+
+ private:
+  /// Existing property with key, or a new one. nullptr if full, counting the dropped property.
+  Property* slot(const char* key) noexcept {
+    for (size_t i = 0; i < size_; i++)
+      if (detail::equal(properties_[i].key, key))
+        return &properties_[i];
+    if (size_ == Capacity) {
+      Property& p = properties_[Capacity];
+      p.key = "dropped_properties";
+      p.type = Property::Type::Unsigned;
+      p.unsigned_value = ++dropped_;
+      return nullptr;
+    }
+    properties_[size_].key = key;
+    return &properties_[size_++];
+  }
+
+  /// Properties, followed by "dropped_properties"
+  Property properties_[Capacity + 1];
+  size_t size_{0};
+  size_t dropped_{0};
+};
+
+/// Information describing a benchmark run, such as the platform or the build configuration.
+using Context = Properties<EMB_CONTEXT_SIZE>;
+
+/// User-defined values of a benchmark, such as bytes or items processed.
+using Counters = Properties<EMB_COUNTERS_SIZE>;
+
+/// A signed fixed-point number with 64-bit storage, usable as an accumulator on targets without a
+/// floating-point unit. Integers, such as timer ticks, convert implicitly.
+/// \tparam FractionBits  number of fractional bits
+template <unsigned FractionBits = 16>
+class Fixed {
+  static_assert(FractionBits < 62, "Fixed requires fewer than 62 fractional bits");
+
+ public:
+  constexpr Fixed() noexcept : raw_{0} {}
+  constexpr Fixed(long long value) noexcept : raw_{value * one()} {}
+
+  /// Number from its raw representation, value * 2^FractionBits
+  static constexpr Fixed fromRaw(long long raw) noexcept { return Fixed(raw, Raw{}); }
+
+  /// Number closest to num / den, rounded towards zero. Divides first, so num may use all bits
+  /// of wide_int, as long as the result fits.
+  static Fixed fromRatio(detail::wide_int num, detail::wide_int den) noexcept {
+    detail::wide_int quotient = num / den;
+    return fromRaw(static_cast<long long>(quotient * one() + (num - quotient * den) * one() / den));
+  }
+
+  constexpr long long raw() const noexcept { return raw_; }
+
+  explicit constexpr operator double() const noexcept { return static_cast<double>(raw_) / one(); }
+  explicit constexpr operator long long() const noexcept { return raw_ / one(); }
+
+  /// Square root, rounded down. 0 for negative numbers.
+  Fixed sqrt() const noexcept {
+    if (raw_ <= 0)
+      return Fixed{};
+    return fromRaw(static_cast<long long>(detail::isqrt(detail::wide_int(raw_) * one())));
+  }
+
+  Fixed& operator+=(const Fixed& other) noexcept {
+    raw_ += other.raw_;
+    return *this;
+  }
+
+  Fixed& operator-=(const Fixed& other) noexcept {
+    raw_ -= other.raw_;
+    return *this;
+  }
+
+  friend constexpr Fixed operator-(const Fixed& a) noexcept { return fromRaw(-a.raw_); }
+  friend constexpr Fixed operator+(const Fixed& a, const Fixed& b) noexcept {
+    return fromRaw(a.raw_ + b.raw_);
+  }
+  friend constexpr Fixed operator-(const Fixed& a, const Fixed& b) noexcept {
+    return fromRaw(a.raw_ - b.raw_);
+  }
+  friend Fixed operator*(const Fixed& a, const Fixed& b) noexcept {
+    return fromRaw(static_cast<long long>(detail::wide_int(a.raw_) * b.raw_ / one()));
+  }
+  friend Fixed operator/(const Fixed& a, const Fixed& b) noexcept {
+    return fromRaw(static_cast<long long>(detail::wide_int(a.raw_) * one() / b.raw_));
+  }
+  friend constexpr Fixed operator/(const Fixed& a, long long b) noexcept {
+    return fromRaw(a.raw_ / b);
+  }
+
+  friend constexpr bool operator==(const Fixed& a, const Fixed& b) noexcept {
+    return a.raw_ == b.raw_;
+  }
+  friend constexpr bool operator!=(const Fixed& a, const Fixed& b) noexcept {
+    return a.raw_ != b.raw_;
+  }
+  friend constexpr bool operator<(const Fixed& a, const Fixed& b) noexcept {
+    return a.raw_ < b.raw_;
+  }
+  friend constexpr bool operator>(const Fixed& a, const Fixed& b) noexcept { return b < a; }
+  friend constexpr bool operator<=(const Fixed& a, const Fixed& b) noexcept { return !(b < a); }
+  friend constexpr bool operator>=(const Fixed& a, const Fixed& b) noexcept { return !(a < b); }
+
+ private:
+  struct Raw {};
+  constexpr Fixed(long long raw, Raw) noexcept : raw_{raw} {}
+  static constexpr long long one() noexcept { return 1LL << FractionBits; }
+
+  long long raw_;
+};
+
+/// Statistics policies, selecting how a benchmark accumulates its iteration times.
+/// A policy has a `collector<Accumulator>` member template, providing update(value, n), called
+/// after each iteration, and forEachStatistic(n, f), calling f(name, value) for each statistic,
+/// where n is the number of iterations so far. It may also provide updateTicks(ticks, n), called
+/// instead of update with the integer timer ticks. Combine policies with statistics::Set.
+namespace statistics {
+
+/// A dimensionless statistic, such as the number of samples in a histogram bin
+struct Count {
+  size_t value;
+
+  size_t count() const noexcept { return value; }
+};
+
+/// Running mean and variance, with Welford's algorithm. Divides on every iteration.
+struct Welford {
+  template <typename Accumulator>
+  class collector {
+   public:
+    void update(const Accumulator& value, size_t n) noexcept {
+      auto delta = value - mean_;
+      mean_ += delta / static_cast<long long>(n);
+      auto delta2 = value - mean_;
+      squared_differences_ += detail::multiply(delta, delta2);
+    }
+
+    Accumulator mean(size_t) const noexcept { return mean_; }
+
+    Accumulator standardDeviation(size_t n) const noexcept {
+      if (n < 2)
+        return Accumulator{0};
+      return detail::convert<Accumulator>(detail::sqrt(squared_differences_ / (n - 1)));
+    }
+
+    template <typename F>
+    void forEachStatistic(size_t n, F& f) const {
+      f("mean", mean(n));
+      f("stddev", standardDeviation(n));
+    }
+
+   private:
+    /// Mean time value in the current iteration
+    Accumulator mean_{0};
+    /// Sum of the squared mean differences, for calculating variance
+    Accumulator squared_differences_{0};
+  };
+};
+
+/// Sums of the values and of their squares, in wide integers. Mean and variance are only computed
+/// for the result, so the measurement loop has no division or floating-point operation.
+/// Values are truncated to integers, so this suits accumulating timer ticks.
+/// \tparam Integer  type of the sums. Must hold the sum of the squared values: without __int128,
+///                  e.g. on 32-bit targets, n * ticks^2 must stay below 2^63, e.g. 2^31
+///                  iterations of up to 2^16 ticks.
+template <typename Integer = detail::wide_int>
+struct IntegerMoments {
+  template <typename Accumulator>
+  class collector {
+   public:
+    void update(const Accumulator& value, size_t n) noexcept {
+      updateTicks(static_cast<long long>(detail::count(value)), n);
+    }
+
+    /// Update from integer timer ticks, which the Benchmarker passes without converting them
+    void updateTicks(long long ticks, size_t) noexcept {
+      Integer x = ticks;
+      sum_ += x;
+      squares_ += x * x;
+    }
+
+    Accumulator mean(size_t n) const noexcept {
+      return n ? detail::ratio<Accumulator>(sum_, n) : Accumulator{0};
+    }
+
+    Accumulator standardDeviation(size_t n) const noexcept {
+      if (n < 2)
+        return Accumulator{0};
+      // With sum(x) = q * n + r, sum(x^2) - q^2 * n - 2 * q * r is (n - 1) * variance + r^2 / n.
+      // No term exceeds sum(x^2), unlike n * sum(x^2) - sum(x)^2.
+      Integer q = sum_ / Integer(n);
+      Integer r = sum_ - q * Integer(n);
+      Integer deviations = squares_ - q * q * Integer(n) - 2 * q * r;
+      auto variance = detail::ratio<Accumulator>(deviations, Integer(n - 1)) -
+                      detail::ratio<Accumulator>(r * r, Integer(n) * Integer(n - 1));
+      return detail::convert<Accumulator>(detail::sqrt(variance));
+    }
+
+    template <typename F>
+    void forEachStatistic(size_t n, F& f) const {
+      f("mean", mean(n));
+      f("stddev", standardDeviation(n));
+    }
+
+   private:
+    Integer sum_{0};
+    Integer squares_{0};
+  };
+};
+
+/// Minimum iteration time. The cheapest policy, with a single comparison per iteration.
+struct Min {
+  template <typename Accumulator>
+  class collector {
+   public:
+    void update(const Accumulator& value, size_t n) noexcept {
+      if (n == 1 || value < min_)
+        min_ = value;
+    }
+
+    Accumulator min() const noexcept { return min_; }
+
+    template <typename F>
+    void forEachStatistic(size_t, F& f) const {
+      f("min", min_);
+    }
+
+   private:
+    Accumulator min_{0};
+  };
+};
+
+/// Maximum iteration time
+struct Max {
+  template <typename Accumulator>
+  class collector {
+   public:
+    void update(const Accumulator& value, size_t n) noexcept {
+      if (n == 1 || max_ < value)
+        max_ = value;
+    }
+
+    Accumulator max() const noexcept { return max_; }
+
+    template <typename F>
+    void forEachStatistic(size_t, F& f) const {
+      f("max", max_);
+    }
+
+   private:
+    Accumulator max_{0};
+  };
+};
+
+/// Histogram of the iteration times, in bins of equal width.
+/// Statistics are named "hist_<lower bound>", and the last bin also counts all larger values.
+/// \tparam Bins   number of bins
+/// \tparam Width  width of each bin, in timer ticks
+template <size_t Bins, unsigned long long Width>
+struct Histogram {
+  static_assert(Bins > 0 && Width > 0, "Histogram requires at least one bin, of non-zero width");
+
+  template <typename Accumulator>
+  class collector {
+   public:
+    void update(const Accumulator& value, size_t) noexcept {
+      long long x = static_cast<long long>(detail::count(value));
+      unsigned long long bin = x > 0 ? static_cast<unsigned long long>(x) / Width : 0;
+      bins_[bin < Bins ? bin : Bins - 1]++;
+    }
 
-/// Embedded MicroBenchmarks namespace
-namespace emb {
+    /// Number of iterations in each bin
+    const size_t* bins() const noexcept { return bins_; }
 
-/// Prevents a variable from being optimized out by the compiler
-/// The dontOptimize and clobberMemory functions are based on Google Benchmark's
-///  DoNotOptimize and ClobberMemory functions, released under the Apache 2.0 License.
-/// Refer to https://github.com/google/benchmark for details on the library and
-///  http://www.apache.org/licenses/LICENSE-2.0 for the license.
-/// Then, if you find out I can't use them this way, tell me. I have no idea how to do it correctly.
-template <typename T>
-inline EMB_ALWAYS_INLINE void dontOptimize(T& data) {
-  asm volatile("" : "+m,r"(data) : : "memory");
-}
+    template <typename F>
+    void forEachStatistic(size_t, F& f) const {
+      static char names[Bins][32];
+      for (size_t i = 0; i < Bins; i++) {
+        detail::indexedName(names[i], sizeof(names[i]), "hist_", i * Width);
+        f(static_cast<const char*>(names[i]), Count{bins_[i]});
+      }
+    }
 
-template <typename T>
-inline EMB_ALWAYS_INLINE void dontOptimize(const T& data) {
-  asm volatile("" : : "r,m"(data) : "memory");
-}
+   private:
+    size_t bins_[Bins]{};
+  };
+};
 
-/// Creates a memory barrier for reads/writes
-inline EMB_ALWAYS_INLINE void clobberMemory() {
-  asm volatile("" : : : "memory");
-}
+/// The first N iteration times, unprocessed. Statistics are named "sample_<index>".
+template <size_t N>
+struct Samples {
+  static_assert(N > 0, "Samples requires space for at least one sample");
+
+  template <typename Accumulator>
+  class collector {
+   public:
+    void update(const Accumulator& value, size_t n) noexcept {
+      if (n <= N)
+        samples_[n - 1] = value;
+    }
+
+    /// Stored samples, in iteration order
+    const Accumulator* samples() const noexcept { return samples_; }
+
+    /// Number of stored samples, after n iterations
+    static size_t size(size_t n) noexcept { return n < N ? n : N; }
+
+    template <typename F>
+    void forEachStatistic(size_t n, F& f) const {
+      static char names[N][32];
+      for (size_t i = 0; i < size(n); i++) {
+        detail::indexedName(names[i], sizeof(names[i]), "sample_", i);
+        f(static_cast<const char*>(names[i]), samples_[i]);
+      }
+    }
+
+   private:
+    Accumulator samples_[N]{};
+  };
+};
+
+/// A combination of statistics policies. The per-iteration update is that of each policy, in
+/// order, and statistics are reported in the same order.
+template <typename... Policies>
+struct Set {
+  template <typename Accumulator>
+  class collector : public Policies::template collector<Accumulator>... {
+   public:
+    void update(const Accumulator& value, size_t n) noexcept {
+      int expand[] = {0, (this->Policies::template collector<Accumulator>::update(value, n), 0)...};
+      (void)expand, (void)value, (void)n;
+    }
+
+    /// Updates each policy's collector with a timer duration, as ticks or as a sample
+    template <typename Conversion, typename Duration>
+    void updateDuration(const Duration& d, size_t n) noexcept {
+      int expand[] = {0,
+          (detail::updateStatistics<Conversion>(
+               static_cast<typename Policies::template collector<Accumulator>&>(*this), d, n, 0),
+              0)...};
+      (void)expand, (void)d, (void)n;
+    }
+
+    template <typename F>
+    void forEachStatistic(size_t n, F& f) const {
+      int expand[] = {
+          0, (this->Policies::template collector<Accumulator>::forEachStatistic(n, f), 0)...};
+      (void)expand, (void)n, (void)f;
+    }
+
+    /// Collector of one of the policies, e.g. get<statistics::Min>().min()
+    template <typename Policy>
+    const typename Policy::template collector<Accumulator>& get() const noexcept {
+      return *this;
+    }
+  };
+};
+
+}  // namespace statistics
 
-/// EMB Implementation details.
 namespace detail {
-/// Determines the time point type for a timer class
-template <typename Timer>
-using default_time_point_t = decltype(Timer::now());
 
-/// Determines the duration type for a time point type
-template <typename TimePoint>
-using duration_t = decltype(EMB_DECLVAL<TimePoint>() - EMB_DECLVAL<TimePoint>());
+/// Most counters the Benchmarker adds to a result, besides those of timers and monitors:
+/// "ambiguous_samples", "cache", "repetition", "stop", and the inputs' "seed" and "working_set"
+constexpr size_t library_counters = 6;
 
-/// Determines the default duration type for a timer class, using the default time point.
-template <typename Timer>
-using default_duration_t = duration_t<default_time_point_t<Timer>>;
+/// Default statistics policy: integer sums for integer accumulators, where Welford's divisions
+/// would truncate, and Welford's algorithm otherwise
+template <typename Accumulator>
+using default_statistics_t =
+    typename conditional<is_integer<decltype(count(EMB_DECLVAL<Accumulator>()))>::value,
+        statistics::IntegerMoments<>, statistics::Welford>::type;
 
-/// Basic multiplication for accumulators
+/// Finds the mean and standard deviation of a Result among the collected statistics
 template <typename Accumulator>
-inline auto multiply(const Accumulator& a1, const Accumulator& a2) -> decltype(a1 * a2) {
-  return a1 * a2;
+struct SummaryFinder {
+  Accumulator mean{0};
+  Accumulator standard_deviation{0};
+  bool found{false};
+  bool found_deviation{false};
+
+  void operator()(const char* name, const Accumulator& value) noexcept {
+    if (!found || equal(name, "mean"))
+      mean = value;
+    if (equal(name, "stddev")) {
+      standard_deviation = value;
+      found_deviation = true;
+    }
+    found = true;
+  }
+
+  template <typename T>
+  void operator()(const char*, const T&) noexcept {}
+};
+
+/// Widens a statistic for precision checks: integers and class types (through their explicit
+/// conversion, like emb::Fixed's) to wide_int, floating-point types to double
+inline double widen(double value) noexcept {
+  return value;
 }
 
-/// Multiplication for std::chrono-like accumulator types, where operator * is not defined,
-/// but a .count() member function is provided
-template <typename Accumulator, decltype(EMB_DECLVAL<Accumulator>().count())* = nullptr>
-inline Accumulator multiply(const Accumulator& a1, const Accumulator& a2) {
-  return Accumulator(a1.count() * a2.count());
+inline double widen(float value) noexcept {
+  return value;
 }
 
-/// Default square root function
-template <typename Accumulator>
-inline auto sqrt(const Accumulator& a) -> decltype(::sqrt(a)) {
-  return ::sqrt(a);
+inline double widen(long double value) noexcept {
+  return static_cast<double>(value);
 }
 
-/// Square root function for std::chrono-like types
-template <typename Accumulator>
-inline auto sqrt(const Accumulator& a) -> decltype(::sqrt(a.count())) {
-  return ::sqrt(a.count());
+template <typename T>
+inline wide_int widen(const T& value) noexcept {
+  return static_cast<wide_int>(static_cast<long long>(value));
+}
+
+/// Whether the half-width of the mean's 95% confidence interval, 1.96 * deviation / sqrt(n),
+/// is within permille thousandths of the mean. Compared squared, without divisions or roots.
+template <typename T>
+inline bool withinPrecision(const T& mean, const T& deviation, size_t n, unsigned permille) {
+  auto m = widen(mean);
+  auto d = widen(deviation);
+  using W = decltype(m);
+  return W(3841600) * d * d <= W(permille) * W(permille) * m * m * W(n);
 }
 
 }  // namespace detail
 
+/// Result of a benchmark
+/// \tparam Conversion  conversion of the collected statistics to accumulator units
+template <typename Accumulator, typename Statistics = detail::default_statistics_t<Accumulator>,
+    typename Conversion = detail::IdentityConversion<Accumulator>>
+struct Result {
+  /// Display name of the benchmark
+  const char* name;
+  /// Number of iterations performed
+  size_t iterations;
+  /// Mean time of an iteration. If the statistics don't include it, their first time statistic.
+  Accumulator mean;
+  /// Standard deviation of the iteration time, or 0 if the statistics don't include it
+  Accumulator standard_deviation;
+  /// Collected statistics. Times are in timer ticks, in the accumulator's count type.
+  typename Statistics::template collector<typename Conversion::sample> statistics;
+  /// Counters set by the benchmark
+  Counters counters;
+  /// Context of the run that produced this result, or nullptr
+  const Context* context;
+
+  /// Calls f(name, value) for each collected statistic, in a fixed order.
+  /// Times are converted to accumulator units. Results without iterations, e.g. benchmarks that
+  /// failed in an isolator, have no statistics.
+  template <typename F>
+  void forEachStatistic(F&& f) const {
+    if (!iterations)
+      return;
+    detail::ConvertingVisitor<Conversion, F> visitor{f};
+    statistics.forEachStatistic(iterations, visitor);
+  }
+};
+
 /// The EMB class responsible for benchmarking
-/// \tparam Timer         a timer class with a public static `now()` function
+/// \tparam Timer         a timer class with a public static `now()` function. It may also provide
+///                       static `start()` and `stop()`, read at each iteration's boundaries.
 /// \tparam Accumulator   an accumulator type
-template <typename Timer, typename Accumulator = detail::default_duration_t<Timer>>
+/// \tparam Capacity      maximum number of benchmarks registered with registerBenchmark, stored
+///                       inline without allocating memory. If 0, EMB_VECTOR is used, if defined.
+/// \tparam Statistics    a statistics policy, from emb::statistics. Defaults to IntegerMoments for
+///                       integer accumulators, Welford otherwise.
+template <typename Timer, typename Accumulator = detail::default_duration_t<Timer>,
+    size_t Capacity = 0, typename Statistics = detail::default_statistics_t<Accumulator>>
 class Benchmarker {
  public:
   // Forward declaration of the State type.
   class State;
 
+  // Forward declaration of the Registration type.
+  class Registration;
+
+  // Forward declaration of the Job type.
+  class Job;
+
+#ifdef EMB_SECTION
+  // Forward declaration of the SectionEntry type.
+  struct SectionEntry;
+#endif
+
   /// Type of benchmarked functions
   using EvaluatorFunction = void (*)(State&);
 
+  /// A benchmark function with its name, for compile-time tables.
+  struct Descriptor {
+    /// Display name of the benchmark
+    const char* name;
+    /// Function to be benchmarked
+    EvaluatorFunction function;
+    /// Number of iterations to be performed, or 0 for the Benchmarker's default
+    size_t iterations;
+  };
+
   /// Default constructor
   /// \param default_iterations Number of iterations to execute benchmarks, where not specified.
   Benchmarker(size_t default_iterations = 1000) : default_iterations_{default_iterations} {}
 
-  /// Register a benchmark, specifying a number of iterations
-  void registerBenchmark(const char* name, EvaluatorFunction e, size_t iterations) {
-    evaluators.push_back({name, e, iterations});
+  /// Constructs registering all benchmarks from a table.
+  /// Tables that don't fit in a fixed Capacity are rejected at compile time.
+  template <size_t N>
+  Benchmarker(const Descriptor (&table)[N], size_t default_iterations = 1000)
+      : default_iterations_{default_iterations} {
+    static_assert(Capacity == 0 || N <= Capacity, "Benchmark table exceeds the Capacity.");
+    for (auto& d : table)
+      registerBenchmark(d.name, d.function, d.iterations ? d.iterations : default_iterations_);
+  }
+
+  /// Register a benchmark, specifying a number of iterations.
+  /// Returns false if the benchmark couldn't be stored, when Capacity is exceeded.
+  bool registerBenchmark(const char* name, EvaluatorFunction e, size_t iterations) {
+    return detail::append(evaluators, Evaluator{name, e, iterations, {}});
   }
 
   /// Register a benchmark, using the default number of iterations.
-  void registerBenchmark(const char* name, EvaluatorFunction e) {
-    evaluators.push_back({name, e, default_iterations_});
+  bool registerBenchmark(const char* name, EvaluatorFunction e) {
+    return registerBenchmark(name, e, default_iterations_);
+  }
+
+  /// Register a callable (e.g. a capturing lambda) as a benchmark, specifying a number of iterations.
+  /// The callable is stored inline in the Evaluator, and must fit in EMB_CALLABLE_SIZE bytes.
+  /// Captureless lambdas convert to EvaluatorFunction and use the function pointer overloads.
+  template <typename Callable, typename detail::enable_if<!detail::is_convertible<Callable,
+                                   EvaluatorFunction>::value>::type* = nullptr>
+  bool registerBenchmark(const char* name, Callable&& c, size_t iterations) {
+    return detail::append(
+        evaluators, Evaluator{name, nullptr, iterations, StoredCallable(static_cast<Callable&&>(c))});
+  }
+
+  /// Register a callable as a benchmark, using the default number of iterations.
+  template <typename Callable, typename detail::enable_if<!detail::is_convertible<Callable,
+                                   EvaluatorFunction>::value>::type* = nullptr>
+  bool registerBenchmark(const char* name, Callable&& c) {
+    return registerBenchmark(name, static_cast<Callable&&>(c), default_iterations_);
+  }
+
+  /// Conversion from the timer ticks collected in the measurement loop to accumulator units
+  using Conversion = detail::TickConversion<Timer, Accumulator>;
+
+  /// Result of a benchmark
+  using Result = emb::Result<Accumulator, Statistics, Conversion>;
+
+  /// Information on the run, given to reporters. May be filled before running benchmarks.
+  Context& context() noexcept { return context_; }
+  const Context& context() const noexcept { return context_; }
+
+  /// Also run each benchmark with cold caches, calling evictor.evict() before each iteration,
+  /// outside the timed region, e.g. with an emb::CacheEvictor. Each benchmark is then reported
+  /// twice, warm and then cold, with a "cache" counter of "warm" or "cold".
+  /// The evictor must outlive the runs.
+  template <typename Evictor>
+  void coldCache(Evictor& evictor) noexcept {
+    evictor_ = &evictor;
+    evict_ = [](void* e) { static_cast<Evictor*>(e)->evict(); };
+  }
+
+  /// Only run benchmarks with warm caches, the default
+  void warmCacheOnly() noexcept {
+    evictor_ = nullptr;
+    evict_ = nullptr;
+  }
+
+  /// Check the environment before running benchmarks, calling checker.check(context()), e.g.
+  /// with an emb::Preflight. The checker records its findings in the context, and returns false
+  /// if benchmarks shouldn't run. The checker must outlive the runs.
+  template <typename Checker>
+  void preflight(Checker& checker) noexcept {
+    checker_ = &checker;
+    check_ = [](void* c, Context& context) { return static_cast<Checker*>(c)->check(context); };
+  }
+
+  /// Run each benchmark through an isolator, calling isolator.run(job) with a Job, e.g. an
+  /// emb::ForkIsolator running it in a child process. The isolator must outlive the runs.
+  template <typename Isolator>
+  void isolate(Isolator& isolator) noexcept {
+    isolator_ = &isolator;
+    isolated_ = [](void* i, Job& job) { static_cast<Isolator*>(i)->run(job); };
+  }
+
+  /// Run benchmarks in this process, the default
+  void inProcess() noexcept {
+    isolator_ = nullptr;
+    isolated_ = nullptr;
+  }
+
+  /// Monitor each benchmark run, e.g. with an emb::ResourceUsage: monitor.begin() is called
+  /// right before the run, and monitor.end(counters, iterations) right after it, to add counters
+  /// to its result. The monitor must outlive the runs.
+  template <typename Monitor>
+  void monitor(Monitor& monitor) noexcept {
+    monitor_ = &monitor;
+    begin_monitor_ = [](void* m) { static_cast<Monitor*>(m)->begin(); };
+    end_monitor_ = [](void* m, Counters& counters, size_t iterations) {
+      static_cast<Monitor*>(m)->end(counters, iterations);
+    };
+  }
+
+  /// Don't monitor benchmark runs, the default
+  void unmonitored() noexcept {
+    monitor_ = nullptr;
+    begin_monitor_ = nullptr;
+    end_monitor_ = nullptr;
+  }
+
+  /// Only run benchmarks whose names match a glob pattern, where '*' matches any sequence and '?'
+  /// any character, e.g. "sort/*". nullptr runs all benchmarks, the default.
+  /// The pattern must outlive the runs.
+  void filter(const char* pattern) noexcept { filter_ = pattern; }
+
+  /// Only run one shard of the benchmarks, for splitting a suite across processes or machines:
+  /// those whose names hash (with FNV-1a) to index, modulo count. The shard is added to the
+  /// context as "shard_index" and "shard_count".
+  void shard(size_t index, size_t count) noexcept {
+    shard_index_ = index;
+    shard_count_ = count ? count : 1;
+    context_.set("shard_index", static_cast<unsigned long long>(shard_index_));
+    context_.set("shard_count", static_cast<unsigned long long>(shard_count_));
+  }
+
+  /// Only run benchmarks for which selector.selected(name) is true, e.g. an emb::BalancedShard.
+  /// The selector must outlive the runs.
+  template <typename Selector>
+  void select(Selector& selector) noexcept {
+    selector_ = &selector;
+    selects_ = [](void* s, const char* name) {
+      return static_cast<Selector*>(s)->selected(name);
+    };
+  }
+
+  /// Stop using the selector given to select()
+  void selectAll() noexcept {
+    selector_ = nullptr;
+    selects_ = nullptr;
+  }
+
+  /// Calls f(name) for each benchmark that would run, in registration order
+  template <typename F>
+  void forEachBenchmark(F&& f) {
+    const size_t n = benchmarkCount();
+    for (size_t i = 0; i < n; i++) {
+      withBenchmark(i, [this, &f](Evaluator& e) {
+        if (selected(e.name))
+          f(static_cast<const char*>(e.name));
+      });
+    }
+  }
+
+  /// Run benchmarks in a pseudo-random order, reproducible from seed, so slow drifts such as
+  /// thermal throttling spread across benchmarks as noise instead of favoring the first ones.
+  /// The seed is added to the context as "shuffle_seed".
+  void shuffle(unsigned long long seed) noexcept {
+    shuffle_ = true;
+    seed_ = seed;
+    context_.set("shuffle_seed", seed);
+  }
+
+  /// Rule for stopping benchmarks as soon as their mean is precise enough
+  struct Precision {
+    /// Target half-width of the mean's 95% confidence interval, in thousandths of the mean, or 0
+    /// to only stop at the limits
+    unsigned permille;
+    /// Iterations before the rule is first checked
+    size_t min_iterations;
+    /// Maximum number of iterations, or 0 for each benchmark's number of iterations
+    size_t max_iterations;
+    /// Maximum measured time of a benchmark, or 0 for no limit
+    Accumulator budget;
+  };
+
+  /// Stop each benchmark once its mean is precise enough, within limits of iterations and time,
+  /// instead of after a fixed number of iterations. The rule needs a statistics policy with a
+  /// "stddev", such as Welford or IntegerMoments, and is checked outside the timed region, every
+  /// eighth of the iterations so far. Each result gets a "stop" counter: "precision", "budget"
+  /// or "iterations".
+  void stopAtPrecision(const Precision& precision) noexcept {
+    precision_ = precision;
+    adaptive_ = true;
+  }
+
+  /// Run each benchmark for its fixed number of iterations, the default
+  void fixedIterations() noexcept { adaptive_ = false; }
+
+  /// Run each benchmark a number of times, adding a "repetition" counter to each result.
+  /// If interleaved, each round runs all benchmarks once, reshuffled every round if shuffling.
+  /// Otherwise, the repetitions of a benchmark run back to back.
+  /// The number of repetitions is added to the context as "repetitions".
+  void repetitions(size_t repetitions, bool interleaved = true) noexcept {
+    repetitions_ = repetitions ? repetitions : 1;
+    interleaved_ = interleaved;
+    context_.set("repetitions", repetitions_);
   }
 
   /// Run all benchmarks
@@ -132,31 +1640,241 @@ class Benchmarker {
   ///         name is a string type (const char*);
   ///         iterations is an unsigned type (size_t);
   ///         mean and standard_deviation have the type of Accumulator.
+  ///         Alternatively, report(const Result&) may be provided.
   ///         Reporter::report(...) is called after each benchmarked function.
+  ///         If provided, begin(const Context&) is called before the first benchmark,
+  ///         and end() after the last one.
+  /// Returns false, without running benchmarks, if a preflight check refused to run.
+  /// Benchmarks from registerBenchmark run first, followed by those from EMB_REGISTER_BENCHMARK
+  /// and, finally, those from EMB_BENCHMARK, unless shuffled.
+  template <typename Reporter>
+  bool runBenchmarks() {
+    Reporter reporter;
+    return runBenchmarks(reporter);
+  }
+
+  /// Run all benchmarks, reporting to a Reporter instance.
+  /// See runBenchmarks() for a description on Reporter.
   template <typename Reporter>
-  void runBenchmarks();
+  bool runBenchmarks(Reporter& reporter) {
+    if (check_ && !check_(checker_, context_))
+      return false;
+    detail::begin(reporter, context_, 0);
+    forEachResult(reporter);
+    detail::end(reporter, 0);
+    return true;
+  }
+
+  /// Run all benchmarks, appending their results to a container with push_back, such as a
+  /// std::vector<Result> or an emb::FixedVector<Result, N>, for programmatic use.
+  /// Returns false if any result didn't fit in the container, or if a preflight check refused to
+  /// run.
+  template <typename Container>
+  bool run(Container& results) {
+    if (check_ && !check_(checker_, context_))
+      return false;
+    Collector<Container> collector{results, true};
+    forEachResult(collector);
+    return collector.ok;
+  }
+
+#ifdef EMB_VECTOR
+  /// Run all benchmarks, returning their results.
+  EMB_VECTOR<Result> run() {
+    EMB_VECTOR<Result> results;
+    run(results);
+    return results;
+  }
+#endif
+
+  /// Report results previously collected with run, as runBenchmarks would.
+  template <typename Reporter, typename Container>
+  void report(const Container& results, Reporter& reporter) const {
+    detail::begin(reporter, context_, 0);
+    for (auto& r : results)
+      detail::report(reporter, r, 0);
+    detail::end(reporter, 0);
+  }
 
  private:
+  /// Inline storage for callables registered as benchmarks
+  using StoredCallable = detail::InlineCallable<State&, EMB_CALLABLE_SIZE>;
+
   /// Internal struct to store the benchmark functions
   struct Evaluator {
     /// Display name of the benchmark
     const char* name;
-    /// Function to be benchmarked
+    /// Function to be benchmarked, or nullptr if a callable is stored
     EvaluatorFunction function;
     /// Number of iterations to be performed
     size_t iterations;
+    /// Callable to be benchmarked, if function is nullptr
+    StoredCallable callable;
+
+    /// Run the benchmark, calling the function pointer directly when possible
+    void run(State& s) {
+      if (function)
+        function(s);
+      else
+        callable(s);
+    }
+  };
+
+  /// Reporter appending results to a container
+  template <typename Container>
+  struct Collector {
+    Container& results;
+    bool ok;
+
+    void report(const Result& r) { ok = detail::append(results, r) && ok; }
   };
 
+  /// Run all benchmarks, reporting each result, without calling begin and end.
+  template <typename Reporter>
+  void forEachResult(Reporter& reporter);
+
+  /// Number of benchmarks, from all sources
+  size_t benchmarkCount() noexcept;
+
+  /// Call f(Evaluator&) with the benchmark at an index, counting registerBenchmark's first, then
+  /// EMB_REGISTER_BENCHMARK's and EMB_BENCHMARK's
+  template <typename F>
+  void withBenchmark(size_t index, F&& f);
+
+  /// Whether a benchmark passes the filter, the shard and the selector
+  bool selected(const char* name) const noexcept {
+    return (!filter_ || detail::matches(filter_, name)) &&
+           detail::fnv1a(name) % shard_count_ == shard_index_ &&
+           (!selects_ || selects_(selector_, name));
+  }
+
+  /// Run a single benchmark and report it, through the isolator if any
+  template <typename Reporter>
+  void runBenchmark(Reporter& reporter, Evaluator& e, size_t repetition);
+
+  /// Run a single benchmark in this process and report it, also with cold caches if enabled
+  template <typename Reporter>
+  void runInProcess(Reporter& reporter, Evaluator& e, size_t repetition);
+
+  /// Measure a benchmark once, with warm or cold caches, and report it
+  template <typename Reporter>
+  void measure(Reporter& reporter, Evaluator& e, bool cold, size_t repetition);
+
+  /// Evaluator for a benchmark from a table
+  Evaluator evaluator(const Descriptor& d) const noexcept {
+    return Evaluator{d.name, d.function, d.iterations ? d.iterations : default_iterations_, {}};
+  }
+
+  /// Information on the run
+  Context context_;
   /// Default number of iterations for this benchmark
   size_t default_iterations_;
+  /// Cache evictor for cold runs, and the function calling it, or nullptr
+  void* evictor_{nullptr};
+  void (*evict_)(void*){nullptr};
+  /// Preflight checker, and the function calling it, or nullptr
+  void* checker_{nullptr};
+  bool (*check_)(void*, Context&){nullptr};
+  /// Pattern of the benchmarks to run, or nullptr for all
+  const char* filter_{nullptr};
+  /// Shard to run, by name hash
+  size_t shard_index_{0};
+  size_t shard_count_{1};
+  /// Selector, and the function calling it, or nullptr
+  void* selector_{nullptr};
+  bool (*selects_)(void*, const char*){nullptr};
+  /// Isolator, and the function calling it, or nullptr
+  void* isolator_{nullptr};
+  void (*isolated_)(void*, Job&){nullptr};
+  /// Monitor, and the functions calling it, or nullptr
+  void* monitor_{nullptr};
+  void (*begin_monitor_)(void*){nullptr};
+  void (*end_monitor_)(void*, Counters&, size_t){nullptr};
+  /// Execution order: shuffled or not, its seed, and repetitions
+  bool shuffle_{false};
+  unsigned long long seed_{0};
+  size_t repetitions_{1};
+  bool interleaved_{true};
+  /// Stopping rule, if adaptive
+  Precision precision_{};
+  bool adaptive_{false};
   /// Collection of benchmarks to execute
-  EMB_VECTOR<Evaluator> evaluators;
+  typename detail::registry<Evaluator, Capacity>::type evaluators;
+};
+
+/// A benchmark registered at static initialization time, to all Benchmarkers of this type.
+/// Registrations are linked into an intrusive list, so no container or allocation is needed.
+/// Use the EMB_REGISTER_BENCHMARK macro to create a static instance.
+template <typename Timer, typename Accumulator, size_t Capacity, typename Statistics>
+class Benchmarker<Timer, Accumulator, Capacity, Statistics>::Registration {
+  friend Benchmarker;
+
+ public:
+  /// Appends this benchmark to the list. Must have static storage duration.
+  /// \param iterations Number of iterations, or 0 for the Benchmarker's default.
+  Registration(const char* name, EvaluatorFunction function, size_t iterations = 0) noexcept
+      : descriptor_{name, function, iterations} {
+    Registration*& tail = last();
+    if (tail)
+      tail->next_ = this;
+    else
+      first() = this;
+    tail = this;
+  }
+
+  Registration(const Registration&) = delete;
+  Registration& operator=(const Registration&) = delete;
+
+ private:
+  /// Head of the list. Constant-initialized, so it's safe to use during static initialization.
+  static Registration*& first() noexcept {
+    static Registration* head = nullptr;
+    return head;
+  }
+
+  /// Tail of the list, to keep the declaration order within a translation unit.
+  static Registration*& last() noexcept {
+    static Registration* tail = nullptr;
+    return tail;
+  }
+
+  const Descriptor descriptor_;
+  Registration* next_{nullptr};
+};
+
+#ifdef EMB_SECTION
+/// A benchmark stored in a constant table, in the EMB_SECTION linker section.
+/// Use the EMB_BENCHMARK macro to create one.
+/// The section is shared by all Benchmarker types, so each entry is tagged with its type.
+template <typename Timer, typename Accumulator, size_t Capacity, typename Statistics>
+struct Benchmarker<Timer, Accumulator, Capacity, Statistics>::SectionEntry {
+  /// Unique address per Benchmarker type
+  static const char tag;
+
+  /// Address of the Benchmarker type's tag
+  const char* type;
+  /// The benchmark
+  Descriptor descriptor;
+
+  /// First entry of the section
+  static const SectionEntry* begin() noexcept {
+    return reinterpret_cast<const SectionEntry*>(EMB_DETAIL_SECTION_START);
+  }
+
+  /// One past the last entry of the section
+  static const SectionEntry* end() noexcept {
+    return reinterpret_cast<const SectionEntry*>(EMB_DETAIL_SECTION_STOP);
+  }
 };
 
+template <typename Timer, typename Accumulator, size_t Capacity, typename Statistics>
+const char Benchmarker<Timer, Accumulator, Capacity, Statistics>::SectionEntry::tag = 0;
+#endif  // EMB_SECTION
+
 /// Contains the state of a running benchmark.
 /// Non-copyable and non-movable type, intended to be used in a range-for loop.
-template <typename Timer, typename Accumulator>
-class Benchmarker<Timer, Accumulator>::State {
+template <typename Timer, typename Accumulator, size_t Capacity, typename Statistics>
+class Benchmarker<Timer, Accumulator, Capacity, Statistics>::State {
   // Forward declaration of the State::Iterator class
   class Iterator;
 
@@ -170,55 +1888,201 @@ class Benchmarker<Timer, Accumulator>::State {
   /// Duration type
   using duration = detail::default_duration_t<Timer>;
 
+  /// Type of the collected iteration times
+  using sample = typename Conversion::sample;
+
  public:
   Iterator begin() noexcept;
   Iterator end() noexcept;
 
+  /// User-defined counters, reported with the results, e.g. counters().set("bytes", size)
+  Counters& counters() noexcept { return counters_; }
+
+  /// Index of the current iteration, from 0
+  size_t iteration() const noexcept { return iteration_; }
+
+  /// Input for the current iteration, from a source with a next() function, such as an
+  /// emb::BufferPool or emb::Generator. Sources used on the first iteration may add counters
+  /// describing themselves with a describe(Counters&) function, called after that iteration,
+  /// outside the timed region, for up to 2 sources. If a source has a prepare() function, it's
+  /// called before each following iteration, outside the timed region too. Only the last
+  /// source with prepare() used on the first iteration is prepared.
+  template <typename Source>
+  auto input(Source& source) -> decltype(source.next()) {
+    if (iteration_ == 0) {
+      auto describe = detail::describeHook<Counters>(source, 0);
+      if (describe && described_ < 2)
+        descriptions_[described_++] = {describe, &source};
+      if (auto hook = detail::prepareHook(source, 0)) {
+        prepare_ = hook;
+        prepare_data_ = &source;
+      }
+    }
+    return source.next();
+  }
+
  // Everything except for iterator access
  private:
-  State(size_t iterations) : iterations_{iterations} {};
+  State(size_t iterations, void (*before_iteration)(void*) = nullptr, void* hook_data = nullptr,
+      const Precision* precision = nullptr)
+      : iterations_{precision && precision->max_iterations ? precision->max_iterations
+                                                           : iterations},
+        before_iteration_{before_iteration},
+        hook_data_{hook_data},
+        precision_{precision},
+        next_check_{precision && precision->min_iterations > 2 ? precision->min_iterations : 2} {};
   State(const State&) = delete;
   State(State&&) = delete;
 
-  /// Update the statistics after each loop iteration, using Welford's algorithm
+  /// Update the statistics after each loop iteration
   void update(const duration& d) noexcept {
     iteration_++;
-    auto value = Accumulator(d);
-    auto delta = value - mean_;
-    mean_ += delta / iteration_;
-    auto delta2 = value - mean_;
-    squared_differences_ += detail::multiply(delta, delta2);
+    if (precision_)
+      elapsed_ += Conversion::fromTicks(d);
+    detail::updateStatistics<Conversion>(statistics_, d, iteration_, 0);
+  }
+
+  /// Adds the counters of the input sources used on the first iteration, outside the timed region
+  void describeInputs() {
+    for (size_t i = 0; i < described_; i++)
+      descriptions_[i].describe(descriptions_[i].source, counters_);
+    described_ = 0;
+  }
+
+  /// Runs the hooks before an iteration, if any, outside the timed region
+  void beforeIteration() noexcept {
+    if (prepare_)
+      prepare_(prepare_data_);
+    if (before_iteration_)
+      before_iteration_(hook_data_);
   }
 
   /// Whether benchmark has finished
-  bool done() noexcept { return iteration_ >= iterations_; }
+  bool done() noexcept {
+    if (iteration_ >= iterations_) {
+      stop_ = "iterations";
+      return true;
+    }
+    if (!precision_ || iteration_ < next_check_)
+      return false;
+    next_check_ = iteration_ + (iteration_ / 8 ? iteration_ / 8 : 1);
+    return stopEarly();
+  }
 
-  /// Report an individual benchmark.
-  /// See Benchmarker::runBenchmarks for a description on Reporter.
-  template <typename Reporter>
-  void report(const char* name);
+  /// Checks the stopping rule's budget and precision
+  bool stopEarly() noexcept {
+    if (Accumulator{0} < precision_->budget &&
+        !(Conversion::toAccumulator(elapsed_) < precision_->budget)) {
+      stop_ = "budget";
+      return true;
+    }
+    if (!precision_->permille)
+      return false;
+    detail::SummaryFinder<sample> summary;
+    statistics_.forEachStatistic(iteration_, summary);
+    if (summary.found_deviation &&
+        detail::withinPrecision(
+            summary.mean, summary.standard_deviation, iteration_, precision_->permille)) {
+      stop_ = "precision";
+      return true;
+    }
+    return false;
+  }
+
+  /// Results of an individual benchmark.
+  Result result(const char* name) const;
 
   /// Number of iterations to perform
   const size_t iterations_;
   /// Current iteration
   size_t iteration_{0};
-  /// Mean time value in the current iteration
-  Accumulator mean_{0};
-  /// Sum of the squared mean differences, for calculating variance
-  Accumulator squared_differences_{0};
+  /// Hook called before each iteration, and its data
+  void (*const before_iteration_)(void*);
+  void* const hook_data_;
+  /// Input source prepared before each iteration, if any
+  void (*prepare_)(void*){nullptr};
+  void* prepare_data_{nullptr};
+  /// Input sources to describe after the first iteration
+  struct Description {
+    void (*describe)(void*, Counters&);
+    void* source;
+  };
+  Description descriptions_[2]{};
+  size_t described_{0};
+  /// Stopping rule, if adaptive, the iteration it's checked next, and why the benchmark stopped
+  const Precision* const precision_;
+  size_t next_check_;
+  const char* stop_{nullptr};
+  /// Total measured time, only kept for stopping rules
+  sample elapsed_{0};
+  /// Statistics of the iteration times
+  typename Statistics::template collector<sample> statistics_;
+  /// User-defined counters
+  Counters counters_;
+};
+
+/// A benchmark to be run by an isolator. The isolator calls run(sink), e.g. in a child process,
+/// and passes the results, or a failure, back with report(result) or fail(error).
+template <typename Timer, typename Accumulator, size_t Capacity, typename Statistics>
+class Benchmarker<Timer, Accumulator, Capacity, Statistics>::Job {
+  friend Benchmarker;
+
+ public:
+  using Result = Benchmarker::Result;
+
+  /// Display name of the benchmark
+  const char* name() const noexcept { return evaluator_.name; }
+
+  /// Runs the benchmark in this process, passing each result to sink.report(const Result&).
+  /// With cold caches enabled, there are two results.
+  template <typename Sink>
+  void run(Sink& sink) {
+    benchmarker_.runInProcess(sink, evaluator_, repetition_);
+  }
+
+  /// Reports a result
+  void report(const Result& result) { report_(reporter_, result); }
+
+  /// Reports that the benchmark failed, as a result without iterations or statistics, and with
+  /// an "error" counter, a "signal" counter if nonzero, and the "repetition" counter if repeating
+  void fail(const char* error, int signal = 0) {
+    Result result{evaluator_.name, 0, Accumulator{0}, Accumulator{0}, {}, {},
+        &benchmarker_.context_};
+    result.counters.set("error", error);
+    if (signal)
+      result.counters.set("signal", signal);
+    if (benchmarker_.repetitions_ > 1)
+      result.counters.set("repetition", repetition_);
+    report(result);
+  }
+
+ private:
+  Job(Benchmarker& benchmarker, Evaluator& evaluator, size_t repetition, void* reporter,
+      void (*report)(void*, const Result&)) noexcept
+      : benchmarker_(benchmarker),
+        evaluator_(evaluator),
+        repetition_{repetition},
+        reporter_{reporter},
+        report_{report} {}
+
+  Benchmarker& benchmarker_;
+  Evaluator& evaluator_;
+  const size_t repetition_;
+  void* const reporter_;
+  void (*const report_)(void*, const Result&);
 };
 
 /// A basic iterator class for a benchmark
-template <typename Timer, typename Accumulator>
-class Benchmarker<Timer, Accumulator>::State::Iterator {
+template <typename Timer, typename Accumulator, size_t Capacity, typename Statistics>
+class Benchmarker<Timer, Accumulator, Capacity, Statistics>::State::Iterator {
   /// RAII helper to measure the time of an iteration
   struct IterationTimer {
     /// Constructs with current time
-    IterationTimer(State& s) noexcept : state(s), start{Timer::now()} {}
+    IterationTimer(State& s) noexcept : state(s), start{detail::startReading<Timer>(0)} {}
 
     /// Destroys by loading current time and updating the State
     ~IterationTimer() noexcept {
-      time_point now = Timer::now();
+      time_point now = detail::stopReading<Timer>(0);
       state.update(now - start);
     }
 
@@ -231,10 +2095,14 @@ class Benchmarker<Timer, Accumulator>::State::Iterator {
 
  public:
   // Dereference operator, constructs an IterationTimer for this State
-  IterationTimer operator*() noexcept { return {*state}; }
+  IterationTimer operator*() noexcept {
+    state->beforeIteration();
+    return {*state};
+  }
 
   // Increment operator, ends loop if state.done()
   Iterator& operator++() noexcept {
+    state->describeInputs();
     if (state->done())
       state = nullptr;
     return *this;
@@ -253,33 +2121,137 @@ class Benchmarker<Timer, Accumulator>::State::Iterator {
 // Implementations that needed declarations
 //----------------------------------------------------------------------------------
 
-template <typename Timer, typename Accumulator>
-inline typename Benchmarker<Timer, Accumulator>::State::Iterator
-Benchmarker<Timer, Accumulator>::State::begin() noexcept {
+template <typename Timer, typename Accumulator, size_t Capacity, typename Statistics>
+inline typename Benchmarker<Timer, Accumulator, Capacity, Statistics>::State::Iterator
+Benchmarker<Timer, Accumulator, Capacity, Statistics>::State::begin() noexcept {
   return Iterator{this};
 }
 
-template <typename Timer, typename Accumulator>
-inline typename Benchmarker<Timer, Accumulator>::State::Iterator
-Benchmarker<Timer, Accumulator>::State::end() noexcept {
+template <typename Timer, typename Accumulator, size_t Capacity, typename Statistics>
+inline typename Benchmarker<Timer, Accumulator, Capacity, Statistics>::State::Iterator
+Benchmarker<Timer, Accumulator, Capacity, Statistics>::State::end() noexcept {
   return Iterator{nullptr};
 }
 
-template <typename Timer, typename Accumulator>
+template <typename Timer, typename Accumulator, size_t Capacity, typename Statistics>
+inline typename Benchmarker<Timer, Accumulator, Capacity, Statistics>::Result
+Benchmarker<Timer, Accumulator, Capacity, Statistics>::State::result(const char* name) const {
+  Result result{name, iteration_, Accumulator{0}, Accumulator{0}, statistics_, counters_, nullptr};
+  detail::SummaryFinder<Accumulator> summary;
+  result.forEachStatistic(summary);
+  result.mean = summary.mean;
+  result.standard_deviation = summary.standard_deviation;
+  return result;
+}
+
+template <typename Timer, typename Accumulator, size_t Capacity, typename Statistics>
 template <typename Reporter>
-inline void Benchmarker<Timer, Accumulator>::State::report(const char* name) {
-  Reporter::report(name, iterations_, mean_,
-      Accumulator(detail::sqrt(squared_differences_ / (iterations_ - 1))));
+inline void Benchmarker<Timer, Accumulator, Capacity, Statistics>::forEachResult(
+    Reporter& reporter) {
+  const size_t n = benchmarkCount();
+  const size_t rounds = interleaved_ ? repetitions_ : 1;
+  const size_t repeats = interleaved_ ? 1 : repetitions_;
+  for (size_t round = 0; round < rounds; round++) {
+    for (size_t i = 0; i < n; i++) {
+      size_t index = shuffle_ ? detail::permute(i, n, detail::mix(seed_ + round)) : i;
+      withBenchmark(index, [&](Evaluator& e) {
+        if (!selected(e.name))
+          return;
+        for (size_t repeat = 0; repeat < repeats; repeat++)
+          runBenchmark(reporter, e, round + repeat);
+      });
+    }
+  }
 }
 
-template <typename Timer, typename Accumulator>
+template <typename Timer, typename Accumulator, size_t Capacity, typename Statistics>
+inline size_t Benchmarker<Timer, Accumulator, Capacity, Statistics>::benchmarkCount() noexcept {
+  size_t n = static_cast<size_t>(evaluators.end() - evaluators.begin());
+  for (auto r = Registration::first(); r != nullptr; r = r->next_)
+    n++;
+#ifdef EMB_SECTION
+  for (auto entry = SectionEntry::begin(); entry != SectionEntry::end(); ++entry)
+    if (entry->type == &SectionEntry::tag)
+      n++;
+#endif
+  return n;
+}
+
+template <typename Timer, typename Accumulator, size_t Capacity, typename Statistics>
+template <typename F>
+inline void Benchmarker<Timer, Accumulator, Capacity, Statistics>::withBenchmark(
+    size_t index, F&& f) {
+  const size_t registered = static_cast<size_t>(evaluators.end() - evaluators.begin());
+  if (index < registered) {
+    f(*(evaluators.begin() + index));
+    return;
+  }
+  index -= registered;
+  for (auto r = Registration::first(); r != nullptr; r = r->next_) {
+    if (index-- == 0) {
+      Evaluator e = evaluator(r->descriptor_);
+      f(e);
+      return;
+    }
+  }
+#ifdef EMB_SECTION
+  for (auto entry = SectionEntry::begin(); entry != SectionEntry::end(); ++entry) {
+    if (entry->type == &SectionEntry::tag && index-- == 0) {
+      Evaluator e = evaluator(entry->descriptor);
+      f(e);
+      return;
+    }
+  }
+#endif
+}
+
+template <typename Timer, typename Accumulator, size_t Capacity, typename Statistics>
 template <typename Reporter>
-inline void Benchmarker<Timer, Accumulator>::runBenchmarks() {
-  for (auto& e : evaluators) {
-    State s(e.iterations);
-    e.function(s);
-    s.template report<Reporter>(e.name);
+inline void Benchmarker<Timer, Accumulator, Capacity, Statistics>::runBenchmark(
+    Reporter& reporter, Evaluator& e, size_t repetition) {
+  if (!isolated_) {
+    runInProcess(reporter, e, repetition);
+    return;
   }
+  Job job{*this, e, repetition, &reporter,
+      [](void* r, const Result& result) { detail::report(*static_cast<Reporter*>(r), result, 0); }};
+  isolated_(isolator_, job);
+}
+
+template <typename Timer, typename Accumulator, size_t Capacity, typename Statistics>
+template <typename Reporter>
+inline void Benchmarker<Timer, Accumulator, Capacity, Statistics>::runInProcess(
+    Reporter& reporter, Evaluator& e, size_t repetition) {
+  measure(reporter, e, false, repetition);
+  if (evict_)
+    measure(reporter, e, true, repetition);
+}
+
+template <typename Timer, typename Accumulator, size_t Capacity, typename Statistics>
+template <typename Reporter>
+inline void Benchmarker<Timer, Accumulator, Capacity, Statistics>::measure(
+    Reporter& reporter, Evaluator& e, bool cold, size_t repetition) {
+  detail::takeAmbiguous<Timer>(0);
+  Counters discarded;
+  detail::takeCounters<Timer>(discarded, 0);
+  State s(e.iterations, cold ? evict_ : nullptr, evictor_, adaptive_ ? &precision_ : nullptr);
+  if (begin_monitor_)
+    begin_monitor_(monitor_);
+  e.run(s);
+  if (end_monitor_)
+    end_monitor_(monitor_, s.counters_, s.iteration_);
+  Result result = s.result(e.name);
+  result.context = &context_;
+  if (size_t ambiguous = detail::takeAmbiguous<Timer>(0))
+    result.counters.set("ambiguous_samples", ambiguous);
+  detail::takeCounters<Timer>(result.counters, 0);
+  if (evict_)
+    result.counters.set("cache", cold ? "cold" : "warm");
+  if (repetitions_ > 1)
+    result.counters.set("repetition", repetition);
+  if (adaptive_)
+    result.counters.set("stop", s.stop_);
+  detail::report(reporter, result, 0);
 }
 
 }  // namespace emb
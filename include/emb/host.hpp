@@ -0,0 +1,107 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// host.hpp - Context information for POSIX hosts
+
+// Copyright Joel P. C. Filho 2019 - 2019
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EMB_INCLUDED_HOST_HPP
+#define EMB_INCLUDED_HOST_HPP
+
+#include <emb/emb.hpp>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace emb {
+
+/// Adds information on the host to a context, using Google Benchmark's keys:
+/// date, host_name, executable, num_cpus, mhz_per_cpu and library_build_type.
+/// Strings are stored in static buffers, so this function isn't reentrant.
+/// The build type refers to the translation unit calling it.
+template <size_t N>
+inline void describeHost(Properties<N>& context) {
+  static char date[32];
+  static char host_name[256];
+  static char executable[1024];
+
+  time_t now = time(nullptr);
+  tm local;
+  if (localtime_r(&now, &local) && strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", &local))
+    context.set("date", date);
+
+  if (gethostname(host_name, sizeof(host_name) - 1) == 0)
+    context.set("host_name", host_name);
+
+#ifdef __linux__
+  ssize_t length = readlink("/proc/self/exe", executable, sizeof(executable) - 1);
+  if (length > 0) {
+    executable[length] = '\0';
+    context.set("executable", executable);
+  }
+#else
+  (void)executable;
+#endif
+
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  if (cpus > 0)
+    context.set("num_cpus", cpus);
+
+  if (FILE* f = fopen("/sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_max_freq", "r")) {
+    unsigned long khz;
+    if (fscanf(f, "%lu", &khz) == 1)
+      context.set("mhz_per_cpu", khz / 1000);
+    fclose(f);
+  }
+
+#ifdef NDEBUG
+  context.set("library_build_type", "release");
+#else
+  context.set("library_build_type", "debug");
+#endif
+}
+
+/// Size of the last-level data cache, in bytes, or 0 if unknown. Linux only.
+inline size_t lastLevelCacheSize() {
+  size_t size = 0;
+#ifdef __linux__
+  unsigned best_level = 0;
+  for (int index = 0;; index++) {
+    char path[96];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/", index);
+    char file[128];
+    unsigned level = 0;
+    unsigned long kilobytes = 0;
+    char type[32] = "";
+
+    snprintf(file, sizeof(file), "%slevel", path);
+    FILE* f = fopen(file, "r");
+    if (!f)
+      break;
+    int read = fscanf(f, "%u", &level);
+    fclose(f);
+
+    snprintf(file, sizeof(file), "%stype", path);
+    if ((f = fopen(file, "r"))) {
+      read += fscanf(f, "%31s", type);
+      fclose(f);
+    }
+
+    snprintf(file, sizeof(file), "%ssize", path);
+    if ((f = fopen(file, "r"))) {
+      read += fscanf(f, "%luK", &kilobytes);
+      fclose(f);
+    }
+
+    if (read == 3 && level >= best_level && type[0] != 'I') {
+      best_level = level;
+      size = kilobytes * 1024;
+    }
+  }
+#endif
+  return size;
+}
+
+}  // namespace emb
+
+#endif
@@ -0,0 +1,145 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// inputs.hpp - Per-iteration benchmark inputs
+
+// Copyright Joel P. C. Filho 2019 - 2019
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EMB_INCLUDED_INPUTS_HPP
+#define EMB_INCLUDED_INPUTS_HPP
+
+#include <emb/emb.hpp>
+
+namespace emb {
+
+/// A pool of equally sized input buffers, in memory provided by the caller.
+/// With State::input, each iteration gets the next buffer, so the benchmark's inputs come from a
+/// working set of the pool's total size, e.g. sized for L1, L2, the last-level cache or DRAM.
+/// Build and fill the pool before the benchmark loop, outside the timed region.
+class BufferPool {
+ public:
+  /// Splits memory, of total_bytes, into buffers of buffer_bytes. At least one buffer must fit.
+  BufferPool(void* memory, size_t total_bytes, size_t buffer_bytes) noexcept
+      : memory_{static_cast<char*>(memory)},
+        buffer_bytes_{buffer_bytes},
+        count_{buffer_bytes ? total_bytes / buffer_bytes : 0} {}
+
+  /// Calls f(buffer, buffer_bytes, index) for each buffer, e.g. to generate inputs
+  template <typename F>
+  void fill(F&& f) {
+    for (size_t i = 0; i < count_; i++)
+      f(static_cast<void*>((*this)[i]), buffer_bytes_, i);
+  }
+
+  /// Next buffer, rotating through all of them
+  void* next() noexcept {
+    void* buffer = (*this)[cursor_];
+    if (++cursor_ == count_)
+      cursor_ = 0;
+    return buffer;
+  }
+
+  /// Adds the "working_set" counter, in bytes
+  template <typename Counters>
+  void describe(Counters& counters) const noexcept {
+    counters.set("working_set", static_cast<unsigned long long>(totalBytes()));
+  }
+
+  char* operator[](size_t index) const noexcept { return memory_ + index * buffer_bytes_; }
+
+  /// Number of buffers
+  size_t count() const noexcept { return count_; }
+  size_t bufferBytes() const noexcept { return buffer_bytes_; }
+  /// Bytes used by all buffers
+  size_t totalBytes() const noexcept { return count_ * buffer_bytes_; }
+
+ private:
+  char* memory_;
+  size_t buffer_bytes_;
+  size_t count_;
+  size_t cursor_{0};
+};
+
+/// A small seeded pseudo-random number generator (SplitMix64), for generating inputs.
+/// The same seed always gives the same sequence, on any platform.
+class Random {
+ public:
+  explicit Random(unsigned long long seed) noexcept : state_{seed} {}
+
+  /// Next 64-bit value
+  unsigned long long operator()() noexcept {
+    return detail::mix(state_ += 0x9E3779B97F4A7C15ULL);
+  }
+
+  /// Value in [0, n), or 0 if n is 0
+  unsigned long long below(unsigned long long n) noexcept { return n ? (*this)() % n : 0; }
+
+  /// Whether an event of probability numerator/denominator happens
+  bool chance(unsigned long long numerator, unsigned long long denominator) noexcept {
+    return below(denominator) < numerator;
+  }
+
+ private:
+  unsigned long long state_;
+};
+
+/// Inputs generated by a seeded function, f(Random&) -> T, pre-generated Chunk at a time.
+/// With State::input, each iteration gets the next input, and exhausted chunks are regenerated
+/// between iterations, outside the timed region. The seed is reported as the "seed" counter.
+/// Create it with emb::makeGenerator, before the benchmark loop, so the first chunk is generated
+/// outside the timed region too.
+template <typename T, size_t Chunk, typename Function>
+class Generator {
+  static_assert(Chunk > 0, "Generator needs room for at least one input");
+
+ public:
+  Generator(Function function, unsigned long long seed)
+      : function_(function), random_{seed}, seed_{seed} {
+    generate();
+  }
+
+  /// Next input. Only one input per iteration is pre-generated.
+  const T& next() {
+    if (cursor_ == Chunk)
+      generate();
+    return inputs_[cursor_++];
+  }
+
+  /// Generates a new chunk if the current one is exhausted
+  void prepare() {
+    if (cursor_ == Chunk)
+      generate();
+  }
+
+  /// Adds the "seed" counter
+  template <typename Counters>
+  void describe(Counters& counters) const noexcept {
+    counters.set("seed", seed_);
+  }
+
+  unsigned long long seed() const noexcept { return seed_; }
+
+ private:
+  void generate() {
+    for (size_t i = 0; i < Chunk; i++)
+      inputs_[i] = function_(random_);
+    cursor_ = 0;
+  }
+
+  Function function_;
+  Random random_;
+  const unsigned long long seed_;
+  T inputs_[Chunk];
+  size_t cursor_{0};
+};
+
+/// Creates a Generator of Chunk inputs at a time, from f(Random&) and a seed
+template <size_t Chunk, typename Function>
+inline auto makeGenerator(Function function, unsigned long long seed = 1)
+    -> Generator<decltype(function(EMB_DECLVAL<Random&>())), Chunk, Function> {
+  return {function, seed};
+}
+
+}  // namespace emb
+
+#endif
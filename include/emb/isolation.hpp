@@ -0,0 +1,154 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// isolation.hpp - Running each benchmark in its own process, on POSIX hosts
+
+// Copyright Joel P. C. Filho 2019 - 2019
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EMB_INCLUDED_ISOLATION_HPP
+#define EMB_INCLUDED_ISOLATION_HPP
+
+#include <emb/emb.hpp>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace emb {
+
+namespace detail {
+
+/// Reporter writing raw results to a pipe, for the parent process to read
+template <typename Result>
+struct PipeSink {
+  int fd;
+  bool ok;
+
+  void report(const Result& result) noexcept {
+    const char* data = reinterpret_cast<const char*>(&result);
+    size_t left = sizeof(Result);
+    while (ok && left) {
+      ssize_t written = write(fd, data, left);
+      if (written < 0 && errno == EINTR)
+        continue;
+      ok = written > 0;
+      if (ok) {
+        data += written;
+        left -= static_cast<size_t>(written);
+      }
+    }
+  }
+};
+
+/// Milliseconds on the monotonic clock
+inline long long monotonicMilliseconds() noexcept {
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000LL + now.tv_nsec / 1000000;
+}
+
+}  // namespace detail
+
+/// Isolator running each benchmark in a forked child process, for Benchmarker::isolate, so its
+/// results don't depend on the heap, page tables and caches left by the benchmarks before it.
+/// Results are sent back through a pipe as raw records: the child is a copy of this process, so
+/// their layout, and pointers to keys and string literals, are the same. Strings written by the
+/// child into its memory, e.g. counter values in a buffer, aren't seen by the parent.
+/// A benchmark that crashes, exits or exceeds the timeout is reported as a result without
+/// iterations and with an "error" counter: "crashed" (with a "signal" counter), "exited",
+/// "timeout" or "fork".
+class ForkIsolator {
+ public:
+  /// \param timeout_ms time limit for each benchmark, in milliseconds, or 0 for none
+  explicit ForkIsolator(unsigned long timeout_ms = 0) noexcept : timeout_ms_{timeout_ms} {}
+
+  template <typename Job>
+  void run(Job& job) {
+    using Result = typename Job::Result;
+    static_assert(__is_trivially_copyable(Result), "Results must be trivially copyable");
+
+    int fds[2];
+    if (pipe(fds) != 0) {
+      job.fail("fork");
+      return;
+    }
+    // Output buffered by the parent would otherwise be written by both processes
+    fflush(nullptr);
+    pid_t pid = fork();
+    if (pid < 0) {
+      close(fds[0]);
+      close(fds[1]);
+      job.fail("fork");
+      return;
+    }
+
+    if (pid == 0) {
+      close(fds[0]);
+      detail::PipeSink<Result> sink{fds[1], true};
+      job.run(sink);
+      fflush(nullptr);
+      _exit(sink.ok ? 0 : 1);
+    }
+
+    close(fds[1]);
+    bool timed_out = !receive<Result>(job, fds[0]);
+    close(fds[0]);
+    if (timed_out)
+      kill(pid, SIGKILL);
+
+    int status;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+    }
+    if (timed_out)
+      job.fail("timeout");
+    else if (WIFSIGNALED(status))
+      job.fail("crashed", WTERMSIG(status));
+    else if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+      job.fail("exited");
+  }
+
+ private:
+  /// Reads results from the child until it closes the pipe, reporting each one.
+  /// Returns false on timeout.
+  template <typename Result, typename Job>
+  bool receive(Job& job, int fd) {
+    alignas(Result) char buffer[sizeof(Result)];
+    size_t received = 0;
+    long long deadline = detail::monotonicMilliseconds() + static_cast<long long>(timeout_ms_);
+    for (;;) {
+      int wait = -1;
+      if (timeout_ms_) {
+        long long left = deadline - detail::monotonicMilliseconds();
+        if (left <= 0)
+          return false;
+        wait = static_cast<int>(left < 1000000000 ? left : 1000000000);
+      }
+      pollfd p{fd, POLLIN, 0};
+      int ready = poll(&p, 1, wait);
+      if (ready < 0 && errno == EINTR)
+        continue;
+      if (ready == 0)
+        return false;
+      ssize_t n = ready < 0 ? -1 : read(fd, buffer + received, sizeof(Result) - received);
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0)
+        return true;
+      received += static_cast<size_t>(n);
+      if (received == sizeof(Result)) {
+        job.report(*reinterpret_cast<const Result*>(buffer));
+        received = 0;
+      }
+    }
+  }
+
+  unsigned long timeout_ms_;
+};
+
+}  // namespace emb
+
+#endif
@@ -0,0 +1,221 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// main.hpp - Ready-made command-line driver, for hosted platforms
+//
+// Options of emb::runMain:
+//   --filter=PATTERN   only run benchmarks matching a glob pattern, e.g. "sort/*"
+//   --list             list the benchmarks that would run, without running them
+//   --repetitions=N    run each benchmark N times, in rounds of all benchmarks
+//   --min_time=S       run each benchmark for at least S seconds of measured time
+//   --shuffle[=SEED]   run benchmarks in a shuffled order, from a given or time-based seed
+//   --shard=I/N        only run shard I of N, from 0, by name hash
+//   --baseline=FILE    balance shards by the runtimes in a CSV report of a previous run
+//   --format=FORMAT    console (default), csv, json or binary
+//   --out=FILE         write the report to a file instead of standard output
+//   --help             print the options
+
+// Copyright Joel P. C. Filho 2019 - 2019
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EMB_INCLUDED_MAIN_HPP
+#define EMB_INCLUDED_MAIN_HPP
+
+#include <emb/emb.hpp>
+#include <emb/reporters/binary.hpp>
+#include <emb/reporters/console.hpp>
+#include <emb/reporters/csv.hpp>
+#include <emb/reporters/json.hpp>
+#include <emb/shard.hpp>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace emb {
+
+namespace detail {
+
+/// BinaryReporter output to a stdio stream
+struct FileOutput {
+  FILE* file;
+
+  void put(uint8_t byte) { fputc(byte, file); }
+};
+
+/// Value of a "--name=value" argument, or nullptr if arg is another option
+inline const char* optionValue(const char* arg, const char* name) {
+  size_t length = strlen(name);
+  return strncmp(arg, name, length) == 0 && arg[length] == '=' ? arg + length + 1 : nullptr;
+}
+
+/// Parses an unsigned number, which must be the whole string
+inline bool parseUnsigned(const char* s, unsigned long long& value) {
+  char* end;
+  value = strtoull(s, &end, 0);
+  return *s && *end == '\0';
+}
+
+/// Converts seconds to an accumulator with a known period. Returns false if it's unknown.
+template <typename Accumulator>
+inline bool fromSeconds(double seconds, Accumulator& value) {
+  using sample = decltype(count(EMB_DECLVAL<Accumulator>()));
+  if (!period<Accumulator>::den)
+    return false;
+  value = convert<Accumulator>(
+      static_cast<sample>(seconds * period<Accumulator>::den / period<Accumulator>::num));
+  return true;
+}
+
+inline void printUsage(FILE* out, const char* program) {
+  fprintf(out,
+      "usage: %s [options]\n"
+      "  --filter=PATTERN   only run benchmarks matching a glob pattern, e.g. \"sort/*\"\n"
+      "  --list             list the benchmarks that would run, without running them\n"
+      "  --repetitions=N    run each benchmark N times, in rounds of all benchmarks\n"
+      "  --min_time=S       run each benchmark for at least S seconds of measured time\n"
+      "  --shuffle[=SEED]   run benchmarks in a shuffled order, from a given or time-based seed\n"
+      "  --shard=I/N        only run shard I of N, from 0, by name hash\n"
+      "  --baseline=FILE    balance shards by the runtimes in a CSV report of a previous run\n"
+      "  --format=FORMAT    console (default), csv, json or binary\n"
+      "  --out=FILE         write the report to a file instead of standard output\n"
+      "  --help             print the options\n",
+      program);
+}
+
+}  // namespace detail
+
+/// Configures a Benchmarker from command-line arguments and runs it, reporting in the chosen
+/// format. See the top of this header for the options. Other configuration, such as the context,
+/// preflight checks or isolation, may be done before calling it. With --baseline, the
+/// Benchmarker's selector is replaced while running, and cleared afterwards.
+/// Returns the exit code for main: 0 on success, 1 on invalid arguments or if the run failed.
+template <typename Benchmarker>
+inline int runMain(int argc, char** argv, Benchmarker& benchmarker) {
+  using Accumulator = decltype(EMB_DECLVAL<typename Benchmarker::Result>().mean);
+  const char* program = argc > 0 ? argv[0] : "benchmark";
+  const char* format = "console";
+  const char* out_path = nullptr;
+  const char* baseline = nullptr;
+  unsigned long long shard_index = 0;
+  unsigned long long shard_count = 0;
+  bool list = false;
+
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    const char* value;
+    unsigned long long number;
+    if ((value = detail::optionValue(arg, "--filter"))) {
+      benchmarker.filter(value);
+    } else if (strcmp(arg, "--list") == 0) {
+      list = true;
+    } else if ((value = detail::optionValue(arg, "--repetitions"))) {
+      if (!detail::parseUnsigned(value, number) || number == 0) {
+        fprintf(stderr, "%s: invalid repetitions: %s\n", program, value);
+        return 1;
+      }
+      benchmarker.repetitions(static_cast<size_t>(number));
+    } else if ((value = detail::optionValue(arg, "--min_time"))) {
+      char* end;
+      double seconds = strtod(value, &end);
+      Accumulator budget{0};
+      if (!*value || *end != '\0' || seconds <= 0) {
+        fprintf(stderr, "%s: invalid min_time: %s\n", program, value);
+        return 1;
+      }
+      if (!detail::fromSeconds(seconds, budget)) {
+        fprintf(stderr, "%s: min_time needs an accumulator with a known period\n", program);
+        return 1;
+      }
+      // Without a precision target, benchmarks run until the budget is spent
+      benchmarker.stopAtPrecision({0, 1, 1000000000, budget});
+    } else if (strcmp(arg, "--shuffle") == 0) {
+      benchmarker.shuffle(detail::mix(static_cast<unsigned long long>(time(nullptr)) ^
+                                      static_cast<unsigned long long>(getpid())));
+    } else if ((value = detail::optionValue(arg, "--shuffle"))) {
+      if (!detail::parseUnsigned(value, number)) {
+        fprintf(stderr, "%s: invalid shuffle seed: %s\n", program, value);
+        return 1;
+      }
+      benchmarker.shuffle(number);
+    } else if ((value = detail::optionValue(arg, "--shard"))) {
+      char* end;
+      shard_index = strtoull(value, &end, 10);
+      if (end == value || *end != '/' || !detail::parseUnsigned(end + 1, shard_count) ||
+          shard_index >= shard_count) {
+        fprintf(stderr, "%s: invalid shard, expected I/N with I < N: %s\n", program, value);
+        return 1;
+      }
+    } else if ((value = detail::optionValue(arg, "--baseline"))) {
+      baseline = value;
+    } else if ((value = detail::optionValue(arg, "--format"))) {
+      format = value;
+    } else if ((value = detail::optionValue(arg, "--out"))) {
+      out_path = value;
+    } else if (strcmp(arg, "--help") == 0) {
+      detail::printUsage(stdout, program);
+      return 0;
+    } else {
+      fprintf(stderr, "%s: unknown option: %s\n", program, arg);
+      detail::printUsage(stderr, program);
+      return 1;
+    }
+  }
+
+  bool binary = strcmp(format, "binary") == 0;
+  if (!binary && strcmp(format, "console") != 0 && strcmp(format, "csv") != 0 &&
+      strcmp(format, "json") != 0) {
+    fprintf(stderr, "%s: unknown format: %s\n", program, format);
+    return 1;
+  }
+
+  BalancedShard balanced(static_cast<size_t>(shard_index), static_cast<size_t>(shard_count));
+  if (shard_count && baseline) {
+    if (!balanced.loadBaseline(baseline)) {
+      fprintf(stderr, "%s: can't read baseline: %s\n", program, baseline);
+      return 1;
+    }
+    balanced.assign(benchmarker);
+    benchmarker.select(balanced);
+  } else if (shard_count) {
+    benchmarker.shard(static_cast<size_t>(shard_index), static_cast<size_t>(shard_count));
+  }
+
+  FILE* out = stdout;
+  if (out_path && !(out = fopen(out_path, binary ? "wb" : "w"))) {
+    perror(out_path);
+    if (shard_count && baseline)
+      benchmarker.selectAll();
+    return 1;
+  }
+
+  bool ok;
+  if (list) {
+    benchmarker.forEachBenchmark([out](const char* name) { fprintf(out, "%s\n", name); });
+    ok = true;
+  } else if (binary) {
+    detail::FileOutput output{out};
+    BinaryReporter<detail::FileOutput> reporter(output);
+    ok = benchmarker.runBenchmarks(reporter);
+  } else if (strcmp(format, "csv") == 0) {
+    CsvReporter reporter(out);
+    ok = benchmarker.runBenchmarks(reporter);
+  } else if (strcmp(format, "json") == 0) {
+    JsonReporter reporter(out);
+    ok = benchmarker.runBenchmarks(reporter);
+  } else {
+    ConsoleReporter reporter(out);
+    ok = benchmarker.runBenchmarks(reporter);
+  }
+
+  // The balanced shard doesn't outlive this call
+  if (shard_count && baseline)
+    benchmarker.selectAll();
+  if (out != stdout && fclose(out) != 0)
+    ok = false;
+  return ok ? 0 : 1;
+}
+
+}  // namespace emb
+
+#endif
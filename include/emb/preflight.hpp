@@ -0,0 +1,233 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// preflight.hpp - Checks of the environment for sources of noise, before running benchmarks
+
+// Copyright Joel P. C. Filho 2019 - 2019
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EMB_INCLUDED_PREFLIGHT_HPP
+#define EMB_INCLUDED_PREFLIGHT_HPP
+
+#include <emb/emb.hpp>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace emb {
+
+namespace detail {
+
+/// Reads the first line of a file, without the line break. Returns false if it can't be read.
+inline bool readFirstLine(const char* path, char* line, size_t size) {
+  FILE* f = fopen(path, "r");
+  if (!f)
+    return false;
+  bool ok = fgets(line, static_cast<int>(size), f) != nullptr;
+  fclose(f);
+  if (ok)
+    line[strcspn(line, "\n")] = '\0';
+  return ok;
+}
+
+/// Whether a CPU is in a list such as "1,3-5", as in /sys/devices/system/cpu/isolated
+inline bool inCpuList(const char* list, long cpu) {
+  while (*list) {
+    char* end;
+    long first = strtol(list, &end, 10);
+    if (end == list)
+      return false;
+    long last = first;
+    if (*end == '-')
+      last = strtol(end + 1, &end, 10);
+    if (cpu >= first && cpu <= last)
+      return true;
+    list = *end == ',' ? end + 1 : end;
+  }
+  return false;
+}
+
+}  // namespace detail
+
+/// What to do when a preflight check finds a problem
+enum class PreflightPolicy {
+  /// Print a warning for each problem, then run
+  Warn,
+  /// Print a warning for each problem, and don't run if there's any
+  Refuse,
+};
+
+/// Checks the environment for common sources of noise, for Benchmarker::preflight.
+/// On Linux: the CPU frequency governor, turbo boost, isolated CPUs, load average, SMT and ASLR.
+/// On all hosts: whether the translation unit including this header has optimizations enabled
+/// and assertions disabled.
+/// Findings are added to the context as cpu_scaling_governor, cpu_boost, isolated_cpus,
+/// load_average, smt, aslr, optimizations and assertions, when known, followed by a summary:
+/// preflight ("passed", "warned" or "refused") and preflight_problems.
+/// That's up to 10 entries, so EMB_CONTEXT_SIZE may need raising to fit other information.
+/// Strings are stored in static buffers, so checks aren't reentrant.
+class Preflight {
+ public:
+  explicit Preflight(PreflightPolicy policy = PreflightPolicy::Warn, FILE* warnings = stderr)
+      : policy_{policy}, warnings_{warnings} {}
+
+  /// Runs all checks, adding the findings to a context.
+  /// Returns false if benchmarks shouldn't run, according to the policy.
+  template <size_t N>
+  bool check(Properties<N>& context) {
+    problems_ = 0;
+#ifdef __linux__
+    checkGovernor(context);
+    checkBoost(context);
+    checkIsolation(context);
+    checkLoad(context);
+    checkSmt(context);
+    checkAslr(context);
+#endif
+    checkBuild(context);
+
+    bool refuse = problems_ && policy_ == PreflightPolicy::Refuse;
+    context.set("preflight", problems_ == 0 ? "passed" : refuse ? "refused" : "warned");
+    context.set("preflight_problems", problems_);
+    if (refuse && warnings_)
+      fprintf(warnings_, "emb: preflight: refusing to run, with %u problems\n", problems_);
+    return !refuse;
+  }
+
+  /// Number of problems found by the last check
+  unsigned problems() const noexcept { return problems_; }
+
+ private:
+  void problem(const char* message, const char* value) {
+    problems_++;
+    if (warnings_)
+      fprintf(warnings_, "emb: preflight: %s (%s)\n", message, value);
+  }
+
+#ifdef __linux__
+  template <size_t N>
+  void checkGovernor(Properties<N>& context) {
+    static char governor[32];
+    long cpus = sysconf(_SC_NPROCESSORS_CONF);
+    bool found = false;
+    for (long cpu = 0; cpu < cpus; cpu++) {
+      char path[96];
+      char line[32];
+      snprintf(
+          path, sizeof(path), "/sys/devices/system/cpu/cpu%ld/cpufreq/scaling_governor", cpu);
+      if (!detail::readFirstLine(path, line, sizeof(line)))
+        continue;
+      if (!found || strcmp(line, "performance") != 0)
+        strcpy(governor, line);
+      found = true;
+      if (strcmp(line, "performance") != 0)
+        break;
+    }
+    if (!found)
+      return;
+    context.set("cpu_scaling_governor", static_cast<const char*>(governor));
+    if (strcmp(governor, "performance") != 0)
+      problem("CPU frequency governor isn't performance", governor);
+  }
+
+  template <size_t N>
+  void checkBoost(Properties<N>& context) {
+    char line[8];
+    bool enabled;
+    if (detail::readFirstLine("/sys/devices/system/cpu/cpufreq/boost", line, sizeof(line)))
+      enabled = line[0] == '1';
+    else if (detail::readFirstLine("/sys/devices/system/cpu/intel_pstate/no_turbo", line,
+                 sizeof(line)))
+      enabled = line[0] == '0';
+    else
+      return;
+    context.set("cpu_boost", enabled ? "enabled" : "disabled");
+    if (enabled)
+      problem("turbo boost is enabled, so frequencies vary with load and temperature", "enabled");
+  }
+
+  template <size_t N>
+  void checkIsolation(Properties<N>& context) {
+    static char isolated[256];
+    if (!detail::readFirstLine("/sys/devices/system/cpu/isolated", isolated, sizeof(isolated)))
+      return;
+    if (isolated[0] == '\0') {
+      context.set("isolated_cpus", "none");
+      problem("no CPUs are isolated, e.g. with the isolcpus kernel parameter", "none");
+      return;
+    }
+    context.set("isolated_cpus", static_cast<const char*>(isolated));
+    int cpu = sched_getcpu();
+    if (cpu >= 0 && !detail::inCpuList(isolated, cpu))
+      problem("running on a CPU that isn't isolated, e.g. not pinned with taskset", isolated);
+  }
+
+  template <size_t N>
+  void checkLoad(Properties<N>& context) {
+    char value[16];
+    double load;
+    if (!detail::readFirstLine("/proc/loadavg", value, sizeof(value)) ||
+        sscanf(value, "%lf", &load) != 1)
+      return;
+    value[strcspn(value, " ")] = '\0';
+    context.set("load_average", load);
+    if (load > 1.0)
+      problem("load average is above 1, so other processes compete for the CPUs", value);
+  }
+
+  template <size_t N>
+  void checkSmt(Properties<N>& context) {
+    char line[8];
+    if (!detail::readFirstLine("/sys/devices/system/cpu/smt/active", line, sizeof(line)))
+      return;
+    bool active = line[0] == '1';
+    context.set("smt", active ? "enabled" : "disabled");
+    if (active)
+      problem("SMT is enabled, so sibling threads share the cores' resources", "enabled");
+  }
+
+  template <size_t N>
+  void checkAslr(Properties<N>& context) {
+    char line[16];
+    if (!detail::readFirstLine("/proc/sys/kernel/randomize_va_space", line, sizeof(line)))
+      return;
+    bool enabled = line[0] != '0';
+    // Disabled for this process, e.g. with setarch -R: ADDR_NO_RANDOMIZE in its personality
+    if (detail::readFirstLine("/proc/self/personality", line, sizeof(line)) &&
+        (strtoul(line, nullptr, 16) & 0x0040000))
+      enabled = false;
+    context.set("aslr", enabled ? "enabled" : "disabled");
+    if (enabled)
+      problem("ASLR is enabled, so memory layout, and alignment effects, vary between runs",
+          "enabled");
+  }
+#endif
+
+  template <size_t N>
+  void checkBuild(Properties<N>& context) {
+#ifdef __OPTIMIZE__
+    context.set("optimizations", "enabled");
+#else
+    context.set("optimizations", "disabled");
+    problem("optimizations are disabled", "debug build");
+#endif
+#ifdef NDEBUG
+    context.set("assertions", "disabled");
+#else
+    context.set("assertions", "enabled");
+    problem("assertions are enabled, as NDEBUG isn't defined", "debug build");
+#endif
+  }
+
+  PreflightPolicy policy_;
+  FILE* warnings_;
+  unsigned problems_{0};
+};
+
+}  // namespace emb
+
+#endif
@@ -0,0 +1,146 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// profile.hpp - Machine profiles, as written by the characterize tool
+
+// Copyright Joel P. C. Filho 2019 - 2019
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EMB_INCLUDED_PROFILE_HPP
+#define EMB_INCLUDED_PROFILE_HPP
+
+// Profile format: one "key value" pair per line, where the value is the rest of the line.
+// Empty lines and lines starting with '#' are ignored. Numeric values are read as reals.
+//
+// Keys written by tools/characterize (times in nanoseconds, sizes in bytes):
+//   timer_resolution_ns, timer_overhead_ns, dont_optimize_ns, clobber_memory_ns
+//   latency_ns_<working set size>, memory_latency_ns (only if the sweep went past the caches)
+//   cache_levels, cache_l<level>_bytes, cache_l<level>_latency_ns
+//   bandwidth_buffer_bytes, read_bandwidth_gbps, write_bandwidth_gbps, copy_bandwidth_gbps
+// as well as the host description from emb::describeHost.
+
+#include <emb/emb.hpp>
+#include <emb/reporters/format.hpp>
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace emb {
+
+/// Writes properties as a machine profile
+template <size_t N>
+inline void writeProfile(FILE* out, const Properties<N>& profile) {
+  fputs("# EMB machine profile\n", out);
+  for (auto& p : profile) {
+    fputs(p.key, out);
+    fputc(' ', out);
+    detail::writePropertyValue(out, p, detail::writeRawString);
+    fputc('\n', out);
+  }
+}
+
+/// A machine profile, loaded from a file. Strings are stored inline, so it's non-copyable.
+/// \tparam Capacity  maximum number of entries
+/// \tparam Storage   bytes available for keys and string values
+template <size_t Capacity = 128, size_t Storage = 8192>
+class Profile {
+ public:
+  Profile() = default;
+  Profile(const Profile&) = delete;
+  Profile& operator=(const Profile&) = delete;
+
+  /// Loads a profile file, adding its entries. Returns false if the file can't be read or
+  /// doesn't fit.
+  bool load(const char* path) {
+    FILE* f = fopen(path, "r");
+    if (!f)
+      return false;
+    char line[512];
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), f))
+      ok = parseLine(line);
+    fclose(f);
+    return ok;
+  }
+
+  /// Entry by key, or nullptr
+  const Property* find(const char* key) const noexcept { return properties_.find(key); }
+
+  /// Numeric entry by key, or fallback if it isn't present or isn't a number
+  double number(const char* key, double fallback = 0) const noexcept {
+    const Property* p = find(key);
+    return p && p->type == Property::Type::Real ? p->real : fallback;
+  }
+
+  /// Size of the last cache level found, e.g. for sizing a CacheEvictor's buffer, or 0
+  size_t lastCacheLevelBytes() const noexcept {
+    double levels = number("cache_levels");
+    if (levels < 1)
+      return 0;
+    char key[32];
+    detail::indexedName(key, sizeof(key), "cache_l", static_cast<unsigned long long>(levels));
+    size_t length = 0;
+    while (key[length])
+      length++;
+    const char* suffix = "_bytes";
+    while (*suffix)
+      key[length++] = *suffix++;
+    key[length] = '\0';
+    return static_cast<size_t>(number(key));
+  }
+
+  /// All entries, e.g. for adding them to a Benchmarker's context
+  const Properties<Capacity>& properties() const noexcept { return properties_; }
+
+ private:
+  bool parseLine(char* line) {
+    while (*line == ' ' || *line == '\t')
+      line++;
+    if (*line == '#' || *line == '\n' || *line == '\r' || *line == '\0')
+      return true;
+
+    char* key = line;
+    while (*line && *line != ' ' && *line != '\t' && *line != '\n' && *line != '\r')
+      line++;
+    char* key_end = line;
+    while (*line == ' ' || *line == '\t')
+      line++;
+    char* value = line;
+    char* value_end = value;
+    for (char* c = value; *c && *c != '\n' && *c != '\r'; c++)
+      if (*c != ' ' && *c != '\t')
+        value_end = c + 1;
+    *key_end = '\0';
+    *value_end = '\0';
+
+    const char* stored_key = store(key);
+    if (!stored_key)
+      return false;
+    char* number_end;
+    double number = strtod(value, &number_end);
+    if (*value && *number_end == '\0')
+      return properties_.set(stored_key, number);
+    const char* stored_value = store(value);
+    return stored_value && properties_.set(stored_key, stored_value);
+  }
+
+  /// Copies a string into the storage. nullptr if it doesn't fit.
+  const char* store(const char* s) noexcept {
+    size_t length = 0;
+    while (s[length])
+      length++;
+    if (used_ + length + 1 > Storage)
+      return nullptr;
+    char* stored = storage_ + used_;
+    for (size_t i = 0; i <= length; i++)
+      stored[i] = s[i];
+    used_ += length + 1;
+    return stored;
+  }
+
+  Properties<Capacity> properties_;
+  char storage_[Storage];
+  size_t used_{0};
+};
+
+}  // namespace emb
+
+#endif
@@ -0,0 +1,304 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// binary.hpp - Compact binary reporter, for slow links such as serial ports
+
+// Copyright Joel P. C. Filho 2019 - 2019
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EMB_INCLUDED_REPORTERS_BINARY_HPP
+#define EMB_INCLUDED_REPORTERS_BINARY_HPP
+
+#include <emb/emb.hpp>
+#include <stdint.h>
+
+// Stream format. All multi-byte integers are little endian.
+//
+//   frame   := 0xEB type:u8 length:varint payload[length] crc:u16
+//   crc     := CRC-16/CCITT-FALSE of type, length and payload
+//   varint  := unsigned LEB128. Signed values are zigzag-encoded first.
+//   string  := length:varint bytes[length]
+//   value   := kind:u8 (varint | zigzag varint | f64 | string), by kind & 0x7F.
+//              Bit 0x80 of kind marks time values, in units of the record's period.
+//
+//   Begin   (type 1) := version:varint count:varint (key:string value)[count]
+//   Result  (type 2) := name:string iterations:varint period_num:varint period_den:varint
+//                       count:varint (name:string value)[count]
+//                       counters:varint (key:string value)[counters]
+//                       A 0/0 period means the time unit is unknown.
+//   End     (type 3) := (empty)
+//
+// Frames are self-delimiting, so a decoder may resynchronize on 0xEB after corrupted data.
+
+namespace emb {
+namespace detail {
+namespace binary {
+
+constexpr uint8_t sync = 0xEB;
+constexpr uint8_t version = 1;
+
+/// Record types
+enum class Record : uint8_t { Begin = 1, Result = 2, End = 3 };
+
+/// Value kinds. Same values as Property::Type.
+enum class Kind : uint8_t { String = 0, Signed = 1, Unsigned = 2, Real = 3 };
+
+/// Flag for time values
+constexpr uint8_t time_flag = 0x80;
+
+/// CRC-16/CCITT-FALSE, updated with one byte
+inline uint16_t crc16(uint16_t crc, uint8_t byte) noexcept {
+  crc ^= static_cast<uint16_t>(byte) << 8;
+  for (int i = 0; i < 8; i++)
+    crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+  return crc;
+}
+
+/// Kind of a fundamental numeric type
+template <typename T>
+struct kind_of;
+
+#define EMB_DETAIL_BINARY_KIND(type, k)       \
+  template <>                                 \
+  struct kind_of<type> {                      \
+    static constexpr Kind value = Kind::k;    \
+  }
+
+EMB_DETAIL_BINARY_KIND(signed char, Signed);
+EMB_DETAIL_BINARY_KIND(short, Signed);
+EMB_DETAIL_BINARY_KIND(int, Signed);
+EMB_DETAIL_BINARY_KIND(long, Signed);
+EMB_DETAIL_BINARY_KIND(long long, Signed);
+EMB_DETAIL_BINARY_KIND(unsigned char, Unsigned);
+EMB_DETAIL_BINARY_KIND(unsigned short, Unsigned);
+EMB_DETAIL_BINARY_KIND(unsigned, Unsigned);
+EMB_DETAIL_BINARY_KIND(unsigned long, Unsigned);
+EMB_DETAIL_BINARY_KIND(unsigned long long, Unsigned);
+EMB_DETAIL_BINARY_KIND(float, Real);
+EMB_DETAIL_BINARY_KIND(double, Real);
+EMB_DETAIL_BINARY_KIND(long double, Real);
+
+#undef EMB_DETAIL_BINARY_KIND
+
+template <unsigned FractionBits>
+struct kind_of<Fixed<FractionBits>> {
+  static constexpr Kind value = Kind::Real;
+};
+
+/// Counts bytes, to compute a payload's length before writing it
+struct CountingSink {
+  size_t size{0};
+  void put(uint8_t) noexcept { size++; }
+};
+
+/// Writes bytes to an Output, updating the CRC
+template <typename Output>
+struct FrameSink {
+  Output& output;
+  uint16_t crc;
+  void put(uint8_t byte) {
+    output.put(byte);
+    crc = crc16(crc, byte);
+  }
+};
+
+template <typename Sink>
+inline void putVarint(Sink& sink, unsigned long long value) {
+  while (value >= 0x80) {
+    sink.put(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  sink.put(static_cast<uint8_t>(value));
+}
+
+template <typename Sink>
+inline void putZigzag(Sink& sink, long long value) {
+  putVarint(sink, (static_cast<unsigned long long>(value) << 1) ^
+                      static_cast<unsigned long long>(value >> 63));
+}
+
+template <typename Sink>
+inline void putReal(Sink& sink, double value) {
+  uint64_t bits;
+  __builtin_memcpy(&bits, &value, sizeof(bits));
+  for (int i = 0; i < 8; i++)
+    sink.put(static_cast<uint8_t>(bits >> (8 * i)));
+}
+
+template <typename Sink>
+inline void putString(Sink& sink, const char* s) {
+  size_t length = 0;
+  while (s[length])
+    length++;
+  putVarint(sink, length);
+  for (size_t i = 0; i < length; i++)
+    sink.put(static_cast<uint8_t>(s[i]));
+}
+
+/// Tag for selecting the encoding of a value kind
+template <Kind K>
+struct KindTag {};
+
+template <typename Sink, typename T>
+inline void putValue(Sink& sink, const T& value, KindTag<Kind::Signed>) {
+  putZigzag(sink, static_cast<long long>(value));
+}
+
+template <typename Sink, typename T>
+inline void putValue(Sink& sink, const T& value, KindTag<Kind::Unsigned>) {
+  putVarint(sink, static_cast<unsigned long long>(value));
+}
+
+template <typename Sink, typename T>
+inline void putValue(Sink& sink, const T& value, KindTag<Kind::Real>) {
+  putReal(sink, static_cast<double>(value));
+}
+
+/// Writes a numeric value with its kind
+template <typename Sink, typename T>
+inline void putNumber(Sink& sink, T value, uint8_t flags) {
+  constexpr Kind kind = kind_of<T>::value;
+  sink.put(static_cast<uint8_t>(kind) | flags);
+  putValue(sink, value, KindTag<kind>{});
+}
+
+template <typename Sink>
+inline void putProperty(Sink& sink, const Property& p) {
+  putString(sink, p.key);
+  switch (p.type) {
+    case Property::Type::String:
+      sink.put(static_cast<uint8_t>(Kind::String));
+      putString(sink, p.string);
+      break;
+    case Property::Type::Signed:
+      putNumber(sink, p.signed_value, 0);
+      break;
+    case Property::Type::Unsigned:
+      putNumber(sink, p.unsigned_value, 0);
+      break;
+    case Property::Type::Real:
+      putNumber(sink, p.real, 0);
+      break;
+  }
+}
+
+/// Payload of a Begin record
+template <size_t N>
+struct BeginPayload {
+  const Properties<N>& context;
+
+  template <typename Sink>
+  void write(Sink& sink) const {
+    putVarint(sink, version);
+    putVarint(sink, context.size());
+    for (auto& p : context)
+      putProperty(sink, p);
+  }
+};
+
+/// Payload of a Result record
+template <typename ResultType>
+struct ResultPayload {
+  const ResultType& result;
+
+  /// Type of time values
+  using Time = typename remove_cvref<decltype(result.mean)>::type;
+
+  /// Counts statistics
+  struct Counter {
+    size_t& count;
+    template <typename T>
+    void operator()(const char*, const T&) const {
+      count++;
+    }
+  };
+
+  /// Writes statistics, flagging those of the time type
+  template <typename Sink>
+  struct Writer {
+    Sink& sink;
+    template <typename T>
+    void operator()(const char* name, const T& value) const {
+      putString(sink, name);
+      putNumber(sink, detail::count(value), is_same<T, Time>::value ? time_flag : 0);
+    }
+  };
+
+  template <typename Sink>
+  void write(Sink& sink) const {
+    putString(sink, result.name);
+    putVarint(sink, result.iterations);
+    putVarint(sink, static_cast<unsigned long long>(period<Time>::num));
+    putVarint(sink, static_cast<unsigned long long>(period<Time>::den));
+    size_t count = 0;
+    result.forEachStatistic(Counter{count});
+    putVarint(sink, count);
+    result.forEachStatistic(Writer<Sink>{sink});
+    putVarint(sink, result.counters.size());
+    for (auto& counter : result.counters)
+      putProperty(sink, counter);
+  }
+};
+
+/// Payload of an End record
+struct EndPayload {
+  template <typename Sink>
+  void write(Sink&) const {}
+};
+
+/// Writes a frame. The payload is serialized twice: once for its length, then to the output.
+template <typename Output, typename Payload>
+inline void putFrame(Output& output, Record type, const Payload& payload) {
+  CountingSink counter;
+  payload.write(counter);
+
+  output.put(sync);
+  FrameSink<Output> sink{output, 0xFFFF};
+  sink.put(static_cast<uint8_t>(type));
+  putVarint(sink, counter.size);
+  payload.write(sink);
+  uint16_t crc = sink.crc;
+  output.put(static_cast<uint8_t>(crc));
+  output.put(static_cast<uint8_t>(crc >> 8));
+}
+
+}  // namespace binary
+}  // namespace detail
+
+/// Reporter writing a compact, framed and checksummed binary stream.
+/// Numbers aren't formatted on the target: integers are written as varints and floating point
+/// values as raw doubles. Use the emb_decode tool to convert the stream to JSON or CSV.
+/// \tparam Output a class with a put(uint8_t) member function, e.g. writing to a serial port.
+template <typename Output>
+class BinaryReporter {
+ public:
+  explicit BinaryReporter(Output& output) noexcept : output_(output) {}
+
+  /// Writes the context
+  template <size_t N>
+  void begin(const Properties<N>& context) {
+    detail::binary::putFrame(
+        output_, detail::binary::Record::Begin, detail::binary::BeginPayload<N>{context});
+  }
+
+  /// Writes the start of a run, without context
+  void begin() { begin(Context{}); }
+
+  /// Writes a benchmark result
+  template <typename ResultType>
+  void report(const ResultType& result) {
+    detail::binary::putFrame(output_, detail::binary::Record::Result,
+        detail::binary::ResultPayload<ResultType>{result});
+  }
+
+  /// Writes the end of a run
+  void end() {
+    detail::binary::putFrame(output_, detail::binary::Record::End, detail::binary::EndPayload{});
+  }
+
+ private:
+  Output& output_;
+};
+
+}  // namespace emb
+
+#endif
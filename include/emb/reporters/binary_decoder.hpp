@@ -0,0 +1,302 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// binary_decoder.hpp - Host-side decoder for the BinaryReporter stream
+
+// Copyright Joel P. C. Filho 2019 - 2019
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EMB_INCLUDED_REPORTERS_BINARY_DECODER_HPP
+#define EMB_INCLUDED_REPORTERS_BINARY_DECODER_HPP
+
+#include <emb/reporters/binary.hpp>
+
+#include <chrono>
+#include <limits>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace emb {
+
+/// A benchmark result decoded from a binary stream.
+/// Time statistics are converted to nanoseconds. Strings are owned by the BinaryDecoder.
+struct DecodedResult {
+  /// Type of time values
+  using Time = std::chrono::duration<double, std::nano>;
+
+  /// A decoded statistic
+  struct Statistic {
+    const char* name;
+    double value;
+    bool time;
+  };
+
+  /// Display name of the benchmark
+  const char* name;
+  /// Number of iterations performed
+  size_t iterations;
+  /// Mean time of an iteration, or NaN if it wasn't reported
+  Time mean;
+  /// All statistics, in the reported order
+  std::vector<Statistic> statistics;
+  /// Counters set by the benchmark
+  Properties<32> counters;
+
+  /// Calls f(name, value) for each statistic, with time values as Time
+  template <typename F>
+  void forEachStatistic(F&& f) const {
+    for (auto& s : statistics) {
+      if (s.time)
+        f(s.name, Time(s.value));
+      else
+        f(s.name, s.value);
+    }
+  }
+};
+
+/// Decodes a BinaryReporter stream, passing its records to a handler, e.g. another reporter.
+/// Data may be fed in arbitrary chunks. Corrupted frames are skipped and counted.
+class BinaryDecoder {
+ public:
+  /// Decoded context type
+  using Context = Properties<64>;
+
+  /// \param unknown_unit_ns nanoseconds per unit, for time values without a known period
+  explicit BinaryDecoder(double unknown_unit_ns = 1.0) : unknown_unit_ns_{unknown_unit_ns} {}
+
+  /// Decodes data, calling handler.begin(const Context&), handler.report(const DecodedResult&)
+  /// and handler.end() for each complete record. Call finish() at the end of the stream.
+  template <typename Handler>
+  void decode(const uint8_t* data, size_t size, Handler& handler) {
+    buffer_.insert(buffer_.end(), data, data + size);
+    size_t position = 0;
+    while (true) {
+      while (position < buffer_.size() && buffer_[position] != detail::binary::sync) {
+        position++;
+        skipped_++;
+      }
+      size_t end;
+      Status status = frame(position, end, handler);
+      if (status == Status::Incomplete)
+        break;
+      if (status == Status::Invalid) {
+        position++;
+        errors_++;
+        continue;
+      }
+      position = end;
+    }
+    buffer_.erase(buffer_.begin(), buffer_.begin() + position);
+  }
+
+  /// Ends the stream. A frame left incomplete, e.g. as its length was corrupted, is counted as
+  /// an error, and the data after its start is decoded again, resyncing on the next frame.
+  /// Returns the number of bytes that were left undecoded, 0 if the stream ended cleanly.
+  template <typename Handler>
+  size_t finish(Handler& handler) {
+    size_t left = buffer_.size();
+    while (!buffer_.empty()) {
+      // decode() leaves the buffer starting at an incomplete frame's sync byte
+      buffer_.erase(buffer_.begin());
+      errors_++;
+      decode(nullptr, 0, handler);
+    }
+    return left;
+  }
+
+  /// Number of corrupted frames
+  size_t errors() const noexcept { return errors_; }
+
+  /// Number of bytes outside frames
+  size_t skipped() const noexcept { return skipped_; }
+
+ private:
+  enum class Status { Complete, Incomplete, Invalid };
+
+  /// Bounds-checked reader of a frame's payload
+  struct Reader {
+    const uint8_t* data;
+    const uint8_t* end;
+    bool ok;
+
+    uint8_t byte() {
+      if (data == end) {
+        ok = false;
+        return 0;
+      }
+      return *data++;
+    }
+
+    unsigned long long varint() {
+      unsigned long long value = 0;
+      for (int shift = 0; shift < 64; shift += 7) {
+        uint8_t b = byte();
+        value |= static_cast<unsigned long long>(b & 0x7F) << shift;
+        if (!(b & 0x80))
+          return value;
+      }
+      ok = false;
+      return value;
+    }
+
+    long long zigzag() {
+      unsigned long long v = varint();
+      return static_cast<long long>(v >> 1) ^ -static_cast<long long>(v & 1);
+    }
+
+    double real() {
+      uint64_t bits = 0;
+      for (int i = 0; i < 8; i++)
+        bits |= static_cast<uint64_t>(byte()) << (8 * i);
+      double value;
+      __builtin_memcpy(&value, &bits, sizeof(value));
+      return value;
+    }
+
+    std::string string() {
+      unsigned long long length = varint();
+      if (length > static_cast<unsigned long long>(end - data)) {
+        ok = false;
+        return {};
+      }
+      std::string s(reinterpret_cast<const char*>(data), static_cast<size_t>(length));
+      data += length;
+      return s;
+    }
+  };
+
+  /// Decodes the frame starting at position, if complete
+  template <typename Handler>
+  Status frame(size_t position, size_t& end, Handler& handler) {
+    if (position == buffer_.size())
+      return Status::Incomplete;
+    const uint8_t* begin = buffer_.data() + position + 1;
+    Reader header{begin, buffer_.data() + buffer_.size(), true};
+    uint8_t type = header.byte();
+    unsigned long long length = header.varint();
+    if (!header.ok)
+      return buffer_.size() - position > 11 ? Status::Invalid : Status::Incomplete;
+    size_t available = static_cast<size_t>(header.end - header.data);
+    if (length + 2 > available)
+      return length > max_length ? Status::Invalid : Status::Incomplete;
+
+    uint16_t crc = 0xFFFF;
+    for (const uint8_t* b = begin; b != header.data + length; b++)
+      crc = detail::binary::crc16(crc, *b);
+    const uint8_t* trailer = header.data + length;
+    if ((trailer[0] | (trailer[1] << 8)) != crc)
+      return Status::Invalid;
+
+    Reader payload{header.data, header.data + length, true};
+    if (!record(static_cast<detail::binary::Record>(type), payload, handler))
+      return Status::Invalid;
+    end = static_cast<size_t>(trailer + 2 - buffer_.data());
+    return Status::Complete;
+  }
+
+  /// Decodes a record and passes it to the handler. Returns false if it's malformed.
+  template <typename Handler>
+  bool record(detail::binary::Record type, Reader& r, Handler& handler) {
+    using detail::binary::Kind;
+    using detail::binary::Record;
+    switch (type) {
+      case Record::Begin: {
+        Context context;
+        r.varint();
+        if (!properties(r, context) || !r.ok)
+          return false;
+        handler.begin(context);
+        return true;
+      }
+      case Record::Result: {
+        DecodedResult result;
+        result.name = intern(r.string());
+        result.iterations = static_cast<size_t>(r.varint());
+        unsigned long long num = r.varint();
+        unsigned long long den = r.varint();
+        double unit_ns = den ? 1e9 * num / den : unknown_unit_ns_;
+        result.mean = DecodedResult::Time(std::numeric_limits<double>::quiet_NaN());
+        unsigned long long count = r.varint();
+        bool has_time = false;
+        for (unsigned long long i = 0; i < count && r.ok; i++) {
+          DecodedResult::Statistic s;
+          s.name = intern(r.string());
+          uint8_t kind = r.byte();
+          s.time = (kind & detail::binary::time_flag) != 0;
+          switch (static_cast<Kind>(kind & ~detail::binary::time_flag)) {
+            case Kind::Signed:
+              s.value = static_cast<double>(r.zigzag());
+              break;
+            case Kind::Unsigned:
+              s.value = static_cast<double>(r.varint());
+              break;
+            case Kind::Real:
+              s.value = r.real();
+              break;
+            default:
+              return false;
+          }
+          if (s.time)
+            s.value *= unit_ns;
+          // As in emb::Result, the mean, or the first time statistic without one
+          if (s.time && (std::string(s.name) == "mean" || !has_time)) {
+            result.mean = DecodedResult::Time(s.value);
+            has_time = true;
+          }
+          result.statistics.push_back(s);
+        }
+        if (!properties(r, result.counters) || !r.ok)
+          return false;
+        handler.report(result);
+        return true;
+      }
+      case Record::End:
+        handler.end();
+        return true;
+    }
+    return false;
+  }
+
+  /// Decodes a count and a list of properties
+  template <size_t N>
+  bool properties(Reader& r, Properties<N>& properties) {
+    using detail::binary::Kind;
+    unsigned long long count = r.varint();
+    for (unsigned long long i = 0; i < count && r.ok; i++) {
+      const char* key = intern(r.string());
+      switch (static_cast<Kind>(r.byte())) {
+        case Kind::String:
+          properties.set(key, intern(r.string()));
+          break;
+        case Kind::Signed:
+          properties.set(key, r.zigzag());
+          break;
+        case Kind::Unsigned:
+          properties.set(key, r.varint());
+          break;
+        case Kind::Real:
+          properties.set(key, r.real());
+          break;
+        default:
+          return false;
+      }
+    }
+    return true;
+  }
+
+  /// Stores a string for the decoder's lifetime
+  const char* intern(const std::string& s) { return strings_.insert(s).first->c_str(); }
+
+  /// Frames longer than this are considered corrupted
+  static constexpr unsigned long long max_length = 1 << 20;
+
+  double unknown_unit_ns_;
+  std::vector<uint8_t> buffer_;
+  std::set<std::string> strings_;
+  size_t errors_{0};
+  size_t skipped_{0};
+};
+
+}  // namespace emb
+
+#endif
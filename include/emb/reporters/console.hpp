@@ -0,0 +1,64 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// console.hpp - Human-readable table reporter
+
+// Copyright Joel P. C. Filho 2019 - 2019
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EMB_INCLUDED_REPORTERS_CONSOLE_HPP
+#define EMB_INCLUDED_REPORTERS_CONSOLE_HPP
+
+#include <emb/reporters/format.hpp>
+
+namespace emb {
+
+/// Reporter writing a table for terminals: the context, then one line per benchmark with its
+/// iterations, mean and standard deviation, followed by its counters as key=value.
+class ConsoleReporter {
+ public:
+  /// \param output     stdio stream to write to
+  /// \param time_unit  unit for time types without a known period, e.g. "us" for a double timer.
+  ///                   std::chrono-like types are converted to nanoseconds.
+  explicit ConsoleReporter(FILE* output = stdout, const char* time_unit = "ns") noexcept
+      : out_{output}, time_unit_{time_unit} {}
+
+  /// Writes the context and the table's header
+  template <size_t N>
+  void begin(const Properties<N>& context) {
+    for (auto& p : context) {
+      fprintf(out_, "%s: ", p.key);
+      detail::writePropertyValue(out_, p, detail::writeRawString);
+      fputc('\n', out_);
+    }
+    fprintf(out_, "%-40s %12s %16s %16s\n", "Benchmark", "Iterations", "Mean", "Stddev");
+  }
+
+  /// Writes the table's header, without context
+  void begin() { begin(Context{}); }
+
+  /// Writes a benchmark result, such as an emb::Result
+  template <typename ResultType>
+  void report(const ResultType& result) {
+    using Accumulator = typename detail::remove_cvref<decltype(result.mean)>::type;
+    const char* unit = detail::reportedUnit<Accumulator>(time_unit_);
+    fprintf(out_, "%-40s %12llu %13.6g %-2s %13.6g %-2s", result.name,
+        static_cast<unsigned long long>(result.iterations), detail::reportedValue(result.mean),
+        unit, detail::reportedValue(result.standard_deviation), unit);
+    for (auto& counter : result.counters) {
+      fprintf(out_, " %s=", counter.key);
+      detail::writePropertyValue(out_, counter, detail::writeRawString);
+    }
+    fputc('\n', out_);
+  }
+
+  /// Flushes the output
+  void end() { fflush(out_); }
+
+ private:
+  FILE* out_;
+  const char* time_unit_;
+};
+
+}  // namespace emb
+
+#endif
@@ -0,0 +1,200 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// csv.hpp - CSV reporter
+
+// Copyright Joel P. C. Filho 2019 - 2019
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EMB_INCLUDED_REPORTERS_CSV_HPP
+#define EMB_INCLUDED_REPORTERS_CSV_HPP
+
+#include <emb/reporters/format.hpp>
+
+namespace emb {
+
+/// Reporter writing one CSV line per benchmark.
+/// The columns start as in Google Benchmark's CSV output (name, iterations, real_time, cpu_time,
+/// time_unit, error_occurred, error_message), followed by one column per statistic and one per
+/// counter of the first successful result, except "error", written as error_message.
+/// The header is written with the first successful result: up to 8 failed results before it are
+/// held, and written after it. Beyond that, or if all fail, the header is written without
+/// statistics or counters. Times and statistics of failed benchmarks, and missing counters, are
+/// left empty. Counter columns beyond EMB_COUNTERS_SIZE are dropped.
+/// Context is written before the header, as lines starting with '#'.
+class CsvReporter {
+ public:
+  /// \param output     stdio stream to write to
+  /// \param time_unit  unit for time types without a known period, e.g. "us" for a double timer.
+  ///                   std::chrono-like types are converted to nanoseconds.
+  explicit CsvReporter(FILE* output = stdout, const char* time_unit = "ns") noexcept
+      : out_{output}, time_unit_{time_unit} {}
+
+  /// Writes the context, as comment lines
+  template <size_t N>
+  void begin(const Properties<N>& context) {
+    for (auto& p : context) {
+      fputs("# ", out_);
+      detail::writeCsvString(out_, p.key);
+      fputc(',', out_);
+      detail::writePropertyValue(out_, p, detail::writeCsvString);
+      fputc('\n', out_);
+    }
+    header_ = false;
+    pending_ = 0;
+  }
+
+  /// Writes a benchmark result, such as an emb::Result
+  template <typename ResultType>
+  void report(const ResultType& result) {
+    using Accumulator = typename detail::remove_cvref<decltype(result.mean)>::type;
+    const char* unit = detail::reportedUnit<Accumulator>(time_unit_);
+    if (!header_ && !result.iterations) {
+      if (pending_ < max_pending) {
+        Failure& f = failures_[pending_++];
+        f.name = result.name;
+        f.unit = unit;
+        f.counters = Counters{};
+        for (auto& counter : result.counters)
+          f.counters.set(counter);
+        return;
+      }
+      writeHeader(Failure{});
+    }
+    if (!header_)
+      writeHeader(result);
+
+    FILE* out = out_;
+    detail::writeCsvString(out, result.name);
+    fprintf(out, ",%llu,", static_cast<unsigned long long>(result.iterations));
+    if (result.iterations) {
+      detail::writeNumber(out, detail::reportedValue(result.mean));
+      fputc(',', out);
+      detail::writeNumber(out, detail::reportedValue(result.mean));
+    } else {
+      fputc(',', out);
+    }
+    fputc(',', out);
+    detail::writeCsvString(out, unit);
+    writeError(result.counters);
+    size_t columns = statistics_;
+    result.forEachStatistic(StatisticWriter{out, columns});
+    writeCounters(result.counters, columns);
+  }
+
+  /// Writes the header and failed results, if still held, and flushes the output
+  void end() {
+    if (!header_)
+      writeHeader(Failure{});
+    fflush(out_);
+  }
+
+ private:
+  /// A failed result, held until the header is written
+  struct Failure {
+    const char* name;
+    const char* unit;
+    Counters counters;
+
+    template <typename F>
+    void forEachStatistic(F&&) const {}
+  };
+
+  /// Writes the name of each statistic as a column, counting them
+  struct HeaderWriter {
+    FILE* out;
+    size_t& columns;
+
+    template <typename T>
+    void operator()(const char* name, const T&) const {
+      fputc(',', out);
+      detail::writeCsvString(out, name);
+      columns++;
+    }
+  };
+
+  /// Writes the value of each statistic, up to the number of columns left
+  struct StatisticWriter {
+    FILE* out;
+    size_t& columns;
+
+    template <typename T>
+    void operator()(const char*, const T& value) const {
+      if (!columns)
+        return;
+      fputc(',', out);
+      detail::writeNumber(out, detail::reportedValue(value));
+      columns--;
+    }
+  };
+
+  /// Writes the header, with the statistics and counters of result, then the held failures
+  template <typename ResultType>
+  void writeHeader(const ResultType& result) {
+    FILE* out = out_;
+    fputs("name,iterations,real_time,cpu_time,time_unit,error_occurred,error_message", out);
+    statistics_ = 0;
+    result.forEachStatistic(HeaderWriter{out, statistics_});
+    counters_ = Counters{};
+    for (auto& counter : result.counters) {
+      if (detail::equal(counter.key, "error"))
+        continue;
+      if (counters_.size() == counters_.capacity())
+        break;
+      counters_.set(counter.key, 0);
+      fputc(',', out);
+      detail::writeCsvString(out, counter.key);
+    }
+    fputc('\n', out);
+    header_ = true;
+
+    for (size_t i = 0; i < pending_; i++) {
+      const Failure& f = failures_[i];
+      detail::writeCsvString(out, f.name);
+      fputs(",0,,,", out);
+      detail::writeCsvString(out, f.unit);
+      writeError(f.counters);
+      writeCounters(f.counters, statistics_);
+    }
+    pending_ = 0;
+  }
+
+  /// Writes the error columns, empty without an "error" counter
+  template <typename ResultCounters>
+  void writeError(const ResultCounters& counters) {
+    const Property* error = counters.find("error");
+    fputs(error ? ",true," : ",,", out_);
+    if (error)
+      detail::writePropertyValue(out_, *error, detail::writeCsvString);
+  }
+
+  /// Skips the statistic columns left, and writes the counter columns
+  template <typename ResultCounters>
+  void writeCounters(const ResultCounters& counters, size_t columns) {
+    FILE* out = out_;
+    for (; columns; columns--)
+      fputc(',', out);
+    for (auto& column : counters_) {
+      fputc(',', out);
+      if (const Property* counter = counters.find(column.key))
+        detail::writePropertyValue(out, *counter, detail::writeCsvString);
+    }
+    fputc('\n', out);
+  }
+
+  /// Failed results held before the header, at most
+  static constexpr size_t max_pending = 8;
+
+  FILE* out_;
+  const char* time_unit_;
+  /// Statistic and counter columns, from the first successful result
+  size_t statistics_{0};
+  Counters counters_;
+  bool header_{false};
+  /// Failed results held until the header is written
+  Failure failures_[max_pending];
+  size_t pending_{0};
+};
+
+}  // namespace emb
+
+#endif
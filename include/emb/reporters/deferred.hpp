@@ -0,0 +1,78 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// deferred.hpp - Reporter adapter that delays output until the end of a run
+
+// Copyright Joel P. C. Filho 2019 - 2019
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EMB_INCLUDED_REPORTERS_DEFERRED_HPP
+#define EMB_INCLUDED_REPORTERS_DEFERRED_HPP
+
+#include <emb/emb.hpp>
+
+namespace emb {
+
+/// Reporter adapter storing results in a fixed-size table, and only forwarding them to another
+/// reporter at end(), so output I/O doesn't run between benchmarks and perturb them.
+/// If the table fills up, it's forwarded early, to avoid losing results. See flushes().
+/// \tparam Reporter    reporter to forward to. Its begin and end functions are optional.
+/// \tparam ResultType  type of results, e.g. Benchmarker::Result
+/// \tparam Capacity    number of results stored
+template <typename Reporter, typename ResultType, size_t Capacity>
+class DeferredReporter {
+  static_assert(Capacity > 0, "DeferredReporter requires a non-zero Capacity.");
+
+ public:
+  explicit DeferredReporter(Reporter& reporter) noexcept : reporter_(reporter) {}
+
+  /// Stores the context
+  void begin(const Context& context) noexcept {
+    context_ = context;
+    begun_ = false;
+  }
+
+  /// Starts a run without context
+  void begin() noexcept { begin(Context{}); }
+
+  /// Stores a result. Forwards all stored results if the table is full.
+  void report(const ResultType& result) {
+    if (size_ == Capacity) {
+      flush();
+      flushes_++;
+    }
+    results_[size_++] = result;
+  }
+
+  /// Forwards the context and all stored results, then ends the wrapped reporter's run
+  void end() {
+    flush();
+    detail::end(reporter_, 0);
+    begun_ = false;
+  }
+
+  /// Number of times results were forwarded before end(), due to a full table
+  size_t flushes() const noexcept { return flushes_; }
+
+ private:
+  /// Forwards the context, if not yet done, and stored results
+  void flush() {
+    if (!begun_) {
+      detail::begin(reporter_, context_, 0);
+      begun_ = true;
+    }
+    for (size_t i = 0; i < size_; i++)
+      detail::report(reporter_, results_[i], 0);
+    size_ = 0;
+  }
+
+  Reporter& reporter_;
+  Context context_;
+  ResultType results_[Capacity];
+  size_t size_{0};
+  size_t flushes_{0};
+  bool begun_{false};
+};
+
+}  // namespace emb
+
+#endif
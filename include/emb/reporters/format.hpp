@@ -0,0 +1,116 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// format.hpp - Formatting helpers for the stdio-based reporters
+
+// Copyright Joel P. C. Filho 2019 - 2019
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EMB_INCLUDED_REPORTERS_FORMAT_HPP
+#define EMB_INCLUDED_REPORTERS_FORMAT_HPP
+
+#include <emb/emb.hpp>
+#include <math.h>
+#include <stdio.h>
+
+namespace emb {
+namespace detail {
+
+/// Number of nanoseconds in a unit of T, for std::chrono-like types. 0 if unknown.
+template <typename T>
+struct nanoseconds_per_unit {
+  static constexpr double value =
+      period<T>::den ? 1e9 * period<T>::num / period<T>::den : 0;
+};
+
+/// Value of a statistic, in nanoseconds if it's a time type with known period
+template <typename T>
+inline double reportedValue(const T& value) {
+  double scale = nanoseconds_per_unit<T>::value;
+  double v = static_cast<double>(detail::count(value));
+  return scale ? v * scale : v;
+}
+
+/// Unit of a time statistic: "ns" if its period is known, otherwise the user-defined unit.
+template <typename T>
+inline const char* reportedUnit(const char* unit) {
+  return nanoseconds_per_unit<T>::value ? "ns" : unit;
+}
+
+/// Writes a number. Non-finite values are written as null, as JSON doesn't represent them.
+inline void writeNumber(FILE* out, double value) {
+  if (isfinite(value))
+    fprintf(out, "%.10g", value);
+  else
+    fputs("null", out);
+}
+
+/// Writes a quoted, escaped JSON string
+inline void writeJsonString(FILE* out, const char* s) {
+  fputc('"', out);
+  for (; *s; s++) {
+    unsigned char c = static_cast<unsigned char>(*s);
+    if (c == '"' || c == '\\')
+      fprintf(out, "\\%c", c);
+    else if (c < 0x20)
+      fprintf(out, "\\u%04x", c);
+    else
+      fputc(c, out);
+  }
+  fputc('"', out);
+}
+
+/// Writes a string as is
+inline void writeRawString(FILE* out, const char* s) {
+  fputs(s, out);
+}
+
+/// Writes a CSV field, quoted if needed
+inline void writeCsvString(FILE* out, const char* s) {
+  bool quote = false;
+  for (const char* c = s; *c; c++)
+    if (*c == ',' || *c == '"' || *c == '\n' || *c == '\r')
+      quote = true;
+  if (!quote) {
+    fputs(s, out);
+    return;
+  }
+  fputc('"', out);
+  for (; *s; s++) {
+    if (*s == '"')
+      fputc('"', out);
+    fputc(*s, out);
+  }
+  fputc('"', out);
+}
+
+/// Writes a property value, with strings written by writeString
+inline void writePropertyValue(FILE* out, const Property& p, void (*writeString)(FILE*, const char*)) {
+  switch (p.type) {
+    case Property::Type::String:
+      writeString(out, p.string);
+      break;
+    case Property::Type::Signed:
+      fprintf(out, "%lld", p.signed_value);
+      break;
+    case Property::Type::Unsigned:
+      fprintf(out, "%llu", p.unsigned_value);
+      break;
+    case Property::Type::Real:
+      writeNumber(out, p.real);
+      break;
+  }
+}
+
+/// Integer value of a property, or fallback if it's missing or not an integer
+inline unsigned long long propertyCount(const Property* p, unsigned long long fallback) {
+  if (p && p->type == Property::Type::Unsigned)
+    return p->unsigned_value;
+  if (p && p->type == Property::Type::Signed && p->signed_value >= 0)
+    return static_cast<unsigned long long>(p->signed_value);
+  return fallback;
+}
+
+}  // namespace detail
+}  // namespace emb
+
+#endif
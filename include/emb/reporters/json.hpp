@@ -0,0 +1,118 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// json.hpp - JSON reporter, compatible with Google Benchmark's output format
+
+// Copyright Joel P. C. Filho 2019 - 2019
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EMB_INCLUDED_REPORTERS_JSON_HPP
+#define EMB_INCLUDED_REPORTERS_JSON_HPP
+
+#include <emb/reporters/format.hpp>
+
+namespace emb {
+
+/// Reporter writing JSON in Google Benchmark's format, so its tools (e.g. compare.py) can be used.
+/// Each benchmark is an "iteration" run, with real_time and cpu_time equal to the mean.
+/// All statistics are written as additional fields, in the same unit, followed by the counters.
+/// Repetitions are numbered from the "repetition" counter, out of the context's "repetitions".
+/// Failed results, with an "error" counter, are written with error_occurred and error_message
+/// instead of times.
+class JsonReporter {
+ public:
+  /// \param output     stdio stream to write to
+  /// \param time_unit  unit for time types without a known period, e.g. "us" for a double timer.
+  ///                   std::chrono-like types are converted to nanoseconds.
+  explicit JsonReporter(FILE* output = stdout, const char* time_unit = "ns") noexcept
+      : out_{output}, time_unit_{time_unit} {}
+
+  /// Starts the document, writing the context
+  template <size_t N>
+  void begin(const Properties<N>& context) {
+    fputs("{\n  \"context\": {", out_);
+    bool first = true;
+    for (auto& p : context) {
+      fputs(first ? "\n    " : ",\n    ", out_);
+      detail::writeJsonString(out_, p.key);
+      fputs(": ", out_);
+      detail::writePropertyValue(out_, p, detail::writeJsonString);
+      first = false;
+    }
+    fputs("\n  },\n  \"benchmarks\": [", out_);
+    first_ = true;
+    repetitions_ = detail::propertyCount(context.find("repetitions"), 1);
+  }
+
+  /// Starts the document, without context
+  void begin() { begin(Context{}); }
+
+  /// Writes a benchmark result, such as an emb::Result
+  template <typename ResultType>
+  void report(const ResultType& result) {
+    using Accumulator = typename detail::remove_cvref<decltype(result.mean)>::type;
+    FILE* out = out_;
+    fputs(first_ ? "\n    {" : ",\n    {", out);
+    first_ = false;
+    fputs("\n      \"name\": ", out);
+    detail::writeJsonString(out, result.name);
+    fputs(",\n      \"run_name\": ", out);
+    detail::writeJsonString(out, result.name);
+    fputs(",\n      \"run_type\": \"iteration\",", out);
+    fprintf(out, "\n      \"repetitions\": %llu,", repetitions_);
+    fprintf(out, "\n      \"repetition_index\": %llu,",
+        detail::propertyCount(result.counters.find("repetition"), 0));
+    fputs("\n      \"threads\": 1,", out);
+    fprintf(out, "\n      \"iterations\": %llu,", static_cast<unsigned long long>(result.iterations));
+    const Property* error = result.counters.find("error");
+    if (error) {
+      fputs("\n      \"error_occurred\": true,\n      \"error_message\": ", out);
+      detail::writePropertyValue(out, *error, detail::writeJsonString);
+    } else {
+      fputs("\n      \"real_time\": ", out);
+      detail::writeNumber(out, detail::reportedValue(result.mean));
+      fputs(",\n      \"cpu_time\": ", out);
+      detail::writeNumber(out, detail::reportedValue(result.mean));
+    }
+    fputs(",\n      \"time_unit\": ", out);
+    detail::writeJsonString(out, detail::reportedUnit<Accumulator>(time_unit_));
+    result.forEachStatistic(StatisticWriter{out});
+    for (auto& counter : result.counters) {
+      if (&counter == error)
+        continue;
+      fputs(",\n      ", out);
+      detail::writeJsonString(out, counter.key);
+      fputs(": ", out);
+      detail::writePropertyValue(out, counter, detail::writeJsonString);
+    }
+    fputs("\n    }", out);
+  }
+
+  /// Ends the document
+  void end() {
+    fputs("\n  ]\n}\n", out_);
+    fflush(out_);
+  }
+
+ private:
+  /// Writes each statistic as a field
+  struct StatisticWriter {
+    FILE* out;
+
+    template <typename T>
+    void operator()(const char* name, const T& value) const {
+      fputs(",\n      ", out);
+      detail::writeJsonString(out, name);
+      fputs(": ", out);
+      detail::writeNumber(out, detail::reportedValue(value));
+    }
+  };
+
+  FILE* out_;
+  const char* time_unit_;
+  unsigned long long repetitions_{1};
+  bool first_{true};
+};
+
+}  // namespace emb
+
+#endif
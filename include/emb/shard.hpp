@@ -0,0 +1,138 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// shard.hpp - Shards balanced by the runtimes of a baseline report, for hosted platforms
+
+// Copyright Joel P. C. Filho 2019 - 2019
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EMB_INCLUDED_SHARD_HPP
+#define EMB_INCLUDED_SHARD_HPP
+
+#include <emb/emb.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace emb {
+
+namespace detail {
+
+/// Splits a CSV line into fields, unquoting them
+inline std::vector<std::string> splitCsv(const std::string& line) {
+  std::vector<std::string> fields(1);
+  bool quoted = false;
+  for (size_t i = 0; i < line.size(); i++) {
+    char c = line[i];
+    if (quoted && c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+      fields.back() += '"';
+      i++;
+    } else if (c == '"') {
+      quoted = !quoted;
+    } else if (c == ',' && !quoted) {
+      fields.emplace_back();
+    } else if (c != '\n' && c != '\r') {
+      fields.back() += c;
+    }
+  }
+  return fields;
+}
+
+}  // namespace detail
+
+/// A shard of the benchmarks, for Benchmarker::select, balanced by their last-known runtimes.
+/// Benchmarks in the baseline are assigned longest first, each to the shard with the least total
+/// runtime so far. Others are assigned by name hash, as with Benchmarker::shard. All shards must
+/// use the same baseline and benchmarks, so they compute the same assignment.
+class BalancedShard {
+ public:
+  BalancedShard(size_t index, size_t count) : index_{index}, count_{count ? count : 1} {}
+
+  /// Loads runtimes, as iterations times mean, from a report written by CsvReporter. Rows of the
+  /// same benchmark, e.g. repetitions, are added. Returns false if the file can't be read.
+  bool loadBaseline(const char* path) {
+    std::FILE* f = std::fopen(path, "r");
+    if (!f)
+      return false;
+    int name = -1, iterations = -1, mean = -1;
+    char buffer[4096];
+    while (std::fgets(buffer, sizeof(buffer), f)) {
+      if (buffer[0] == '#' || buffer[0] == '\n')
+        continue;
+      std::vector<std::string> fields = detail::splitCsv(buffer);
+      if (name < 0) {
+        for (size_t i = 0; i < fields.size(); i++) {
+          if (fields[i] == "name")
+            name = static_cast<int>(i);
+          else if (fields[i] == "iterations")
+            iterations = static_cast<int>(i);
+          else if (fields[i] == "real_time")
+            mean = static_cast<int>(i);
+        }
+        if (name < 0 || iterations < 0 || mean < 0)
+          break;
+        continue;
+      }
+      int needed = std::max(name, std::max(iterations, mean));
+      if (static_cast<int>(fields.size()) <= needed)
+        continue;
+      runtimes_[fields[name]] +=
+          std::atof(fields[iterations].c_str()) * std::atof(fields[mean].c_str());
+    }
+    std::fclose(f);
+    return name >= 0 && iterations >= 0 && mean >= 0;
+  }
+
+  /// Assigns the benchmarks that would run, and adds the shard to the benchmarker's context.
+  /// Call it before Benchmarker::select(*this), and after any filter.
+  template <typename Benchmarker>
+  void assign(Benchmarker& benchmarker) {
+    std::vector<std::pair<double, std::string>> known;
+    std::vector<std::string> unknown;
+    benchmarker.forEachBenchmark([&](const char* name) {
+      auto runtime = runtimes_.find(name);
+      if (runtime != runtimes_.end())
+        known.emplace_back(runtime->second, name);
+      else
+        unknown.emplace_back(name);
+    });
+    // Longest first, ties by name, so every shard sorts the same way
+    std::sort(known.begin(), known.end(),
+        [](const std::pair<double, std::string>& a, const std::pair<double, std::string>& b) {
+          return a.first != b.first ? a.first > b.first : a.second < b.second;
+        });
+
+    std::vector<double> loads(count_, 0.0);
+    selected_.clear();
+    for (auto& benchmark : known) {
+      size_t lightest = std::min_element(loads.begin(), loads.end()) - loads.begin();
+      loads[lightest] += benchmark.first;
+      if (lightest == index_)
+        selected_.insert(benchmark.second);
+    }
+    for (auto& name : unknown)
+      if (detail::fnv1a(name.c_str()) % count_ == index_)
+        selected_.insert(name);
+
+    benchmarker.context().set("shard_index", static_cast<unsigned long long>(index_));
+    benchmarker.context().set("shard_count", static_cast<unsigned long long>(count_));
+  }
+
+  /// Whether a benchmark belongs to this shard
+  bool selected(const char* name) const { return selected_.count(name) != 0; }
+
+ private:
+  size_t index_;
+  size_t count_;
+  std::map<std::string, double> runtimes_;
+  std::set<std::string> selected_;
+};
+
+}  // namespace emb
+
+#endif
@@ -0,0 +1,178 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// multi.hpp - Sampling several timers or meters at the same iteration boundaries
+
+// Copyright Joel P. C. Filho 2019 - 2019
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EMB_INCLUDED_TIMERS_MULTI_HPP
+#define EMB_INCLUDED_TIMERS_MULTI_HPP
+
+#include <emb/emb.hpp>
+
+namespace emb {
+
+namespace detail {
+
+/// Readings of a list of metrics
+template <typename... Metrics>
+struct MetricReadings {
+  void read() noexcept {}
+  void readReversed() noexcept {}
+};
+
+template <typename Metric, typename... Rest>
+struct MetricReadings<Metric, Rest...> {
+  default_time_point_t<Metric> first;
+  MetricReadings<Rest...> rest;
+
+  /// Reads the metrics in the list's order
+  void read() noexcept {
+    first = Metric::now();
+    rest.read();
+  }
+
+  /// Reads the metrics in reverse order
+  void readReversed() noexcept {
+    rest.readReversed();
+    first = Metric::now();
+  }
+};
+
+/// Key of a metric's standard deviation counter: its name, followed by "_stddev".
+/// It's built during static initialization, before any process is forked to run benchmarks, so
+/// the parent reporting their results has it too.
+template <typename Metric>
+struct DeviationKey {
+  static const char* const value;
+
+ private:
+  static char key[64];
+
+  static const char* build() noexcept {
+    const char* suffix = "_stddev";
+    size_t i = 0;
+    for (const char* c = Metric::name(); *c && i < sizeof(key) - 8; c++)
+      key[i++] = *c;
+    while (*suffix)
+      key[i++] = *suffix++;
+    return key;
+  }
+};
+
+template <typename Metric>
+char DeviationKey<Metric>::key[64];
+
+template <typename Metric>
+const char* const DeviationKey<Metric>::value = DeviationKey<Metric>::build();
+
+/// Statistics of the differences of a list of metrics, in their units
+template <typename... Metrics>
+struct MetricStatistics {
+  template <typename Readings>
+  void update(const Readings&, const Readings&, size_t) noexcept {}
+
+  template <typename Counters>
+  void report(Counters&, size_t) const noexcept {}
+};
+
+template <typename Metric, typename... Rest>
+struct MetricStatistics<Metric, Rest...> {
+  statistics::Welford::collector<double> first;
+  MetricStatistics<Rest...> rest;
+
+  void update(const MetricReadings<Metric, Rest...>& end,
+      const MetricReadings<Metric, Rest...>& start, size_t n) noexcept {
+    first.update(static_cast<double>(count(end.first - start.first)), n);
+    rest.update(end.rest, start.rest, n);
+  }
+
+  template <typename Counters>
+  void report(Counters& counters, size_t n) const noexcept {
+    counters.set(Metric::name(), first.mean(n));
+    if (n > 1)
+      counters.set(DeviationKey<Metric>::value, first.standardDeviation(n));
+    rest.report(counters, n);
+  }
+};
+
+}  // namespace detail
+
+/// Timer sampling other timers or meters, e.g. CPU time or cycles, at the same iteration
+/// boundaries as the Primary timer. Results are in the primary's time, which the benchmark's
+/// statistics and stopping rules use. Each metric gets its own statistics, as counters:
+///   - name(): mean difference per iteration, in the metric's units
+///   - name() + "_stddev": its standard deviation, if there's more than one iteration
+/// Metrics are timers, with now(), that also provide a static name() for their counters. Raise
+/// EMB_COUNTERS_SIZE to fit their 2 counters each with the Benchmarker's, for more than 1 metric.
+/// Readings are nested, with the primary innermost: the start of an iteration reads the
+/// metrics in reverse order, then the primary, and its end reads the primary, then the metrics
+/// in order. The primary's interval contains no other reading, and each metric's interval those
+/// of the primary and the metrics before it: list the metrics most sensitive to skew first.
+/// Statistics are shared by all benchmarks using the timer, which must run one at a time.
+template <typename Primary, typename... Metrics>
+struct MultiTimer : detail::counter_period<Primary> {
+  /// Readings of all timers
+  struct time_point {
+    detail::default_time_point_t<Primary> primary;
+    detail::MetricReadings<Metrics...> metrics;
+
+    /// The primary's duration between two readings. Adds the metrics' to their statistics.
+    friend detail::default_duration_t<Primary> operator-(
+        const time_point& end, const time_point& start) noexcept {
+      return elapsed(end, start);
+    }
+
+   private:
+    static detail::default_duration_t<Primary> elapsed(
+        const time_point& end, const time_point& start) noexcept {
+      State& s = state();
+      s.statistics.update(end.metrics, start.metrics, ++s.samples);
+      return end.primary - start.primary;
+    }
+  };
+
+  /// Reads the metrics in reverse order, then the primary, as at the start of an iteration
+  static time_point now() noexcept { return start(); }
+
+  /// Reading at the start of an iteration: the metrics in reverse order, then the primary
+  static time_point start() noexcept {
+    time_point t;
+    t.metrics.readReversed();
+    t.primary = Primary::now();
+    return t;
+  }
+
+  /// Reading at the end of an iteration: the primary, then the metrics in order
+  static time_point stop() noexcept {
+    time_point t;
+    t.primary = Primary::now();
+    t.metrics.read();
+    return t;
+  }
+
+  /// Adds the metrics' counters since the last call, and resets their statistics.
+  /// The Benchmarker calls it before and after each benchmark.
+  template <typename Counters>
+  static void takeCounters(Counters& counters) noexcept {
+    State& s = state();
+    if (s.samples)
+      s.statistics.report(counters, s.samples);
+    s = State{};
+  }
+
+ private:
+  struct State {
+    detail::MetricStatistics<Metrics...> statistics;
+    size_t samples{0};
+  };
+
+  static State& state() noexcept {
+    static State s;
+    return s;
+  }
+};
+
+}  // namespace emb
+
+#endif
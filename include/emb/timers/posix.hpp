@@ -0,0 +1,134 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// posix.hpp - Timers for POSIX clocks: monotonic, thread and process CPU time
+
+// Copyright Joel P. C. Filho 2019 - 2019
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EMB_INCLUDED_TIMERS_POSIX_HPP
+#define EMB_INCLUDED_TIMERS_POSIX_HPP
+
+#include <emb/emb.hpp>
+#include <time.h>
+
+namespace emb {
+
+namespace detail {
+
+/// Reading of a POSIX clock, in nanoseconds
+inline long long clockNanoseconds(clockid_t clock) noexcept {
+  timespec t;
+  clock_gettime(clock, &t);
+  return static_cast<long long>(t.tv_sec) * 1000000000LL + static_cast<long long>(t.tv_nsec);
+}
+
+/// Tick period of the POSIX clocks, as num / den seconds
+struct nanoseconds_period {
+  static constexpr long long num = 1;
+  static constexpr long long den = 1000000000;
+};
+
+}  // namespace detail
+
+/// Timer reading a POSIX clock with clock_gettime, in nanoseconds
+template <clockid_t Clock>
+struct PosixTimer {
+  using period = detail::nanoseconds_period;
+
+  static long long now() noexcept { return detail::clockNanoseconds(Clock); }
+};
+
+/// Wall time, as std::chrono::steady_clock on most platforms
+using MonotonicTimer = PosixTimer<CLOCK_MONOTONIC>;
+
+#ifdef CLOCK_MONOTONIC_RAW
+/// Wall time from the hardware clock, without NTP frequency adjustments. Linux only.
+using MonotonicRawTimer = PosixTimer<CLOCK_MONOTONIC_RAW>;
+#endif
+
+#ifdef CLOCK_THREAD_CPUTIME_ID
+/// CPU time of the calling thread: excludes time waiting, preempted, or in other threads
+using ThreadCpuTimer = PosixTimer<CLOCK_THREAD_CPUTIME_ID>;
+#endif
+
+#ifdef CLOCK_PROCESS_CPUTIME_ID
+/// CPU time of all threads of the process
+using ProcessCpuTimer = PosixTimer<CLOCK_PROCESS_CPUTIME_ID>;
+
+/// Timer measuring wall time, while also measuring CPU time on another clock, e.g. for
+/// benchmarks that run threads. Results are in wall time, with counters for the CPU time:
+///   - cpu_time_ns: mean CPU time per iteration, in nanoseconds
+///   - cpu_utilization: CPU time over wall time, e.g. 4 for 4 threads that are always running.
+///     CPU intervals include the CPU clock's readings, so it's inflated for very short iterations.
+/// CPU times are totaled when the Benchmarker subtracts time points, so they're shared by all
+/// benchmarks using the timer, which must run in one thread at a time.
+template <clockid_t Cpu = CLOCK_PROCESS_CPUTIME_ID, clockid_t Wall = CLOCK_MONOTONIC>
+struct WallCpuTimer {
+  using period = detail::nanoseconds_period;
+
+  /// Readings of both clocks
+  struct time_point {
+    long long wall;
+    long long cpu;
+
+    /// Wall time between two readings. Adds their CPU time to the totals.
+    friend long long operator-(const time_point& end, const time_point& start) noexcept {
+      return elapsed(end, start);
+    }
+
+   private:
+    static long long elapsed(const time_point& end, const time_point& start) noexcept {
+      Totals& t = totals();
+      t.wall += end.wall - start.wall;
+      t.cpu += end.cpu - start.cpu;
+      t.samples++;
+      return end.wall - start.wall;
+    }
+  };
+
+  /// Reads the CPU clock, then the wall clock, as at the start of a measurement
+  static time_point now() noexcept { return start(); }
+
+  /// Reading at the start of a measurement. The wall interval is inside the CPU one, so it
+  /// doesn't include the slower CPU clock readings.
+  static time_point start() noexcept {
+    long long cpu = detail::clockNanoseconds(Cpu);
+    return {detail::clockNanoseconds(Wall), cpu};
+  }
+
+  /// Reading at the end of a measurement: the wall clock, then the CPU clock
+  static time_point stop() noexcept {
+    long long wall = detail::clockNanoseconds(Wall);
+    return {wall, detail::clockNanoseconds(Cpu)};
+  }
+
+  /// Adds the CPU time counters since the last call, and resets the totals.
+  /// The Benchmarker calls it before and after each benchmark.
+  template <typename Counters>
+  static void takeCounters(Counters& counters) noexcept {
+    Totals& t = totals();
+    if (t.samples) {
+      counters.set("cpu_time_ns", t.cpu / t.samples);
+      if (t.wall > 0)
+        counters.set("cpu_utilization", static_cast<double>(t.cpu) / static_cast<double>(t.wall));
+    }
+    t = Totals{0, 0, 0};
+  }
+
+ private:
+  struct Totals {
+    long long wall;
+    long long cpu;
+    long long samples;
+  };
+
+  static Totals& totals() noexcept {
+    static Totals t{0, 0, 0};
+    return t;
+  }
+};
+#endif
+
+}  // namespace emb
+
+#endif
@@ -0,0 +1,200 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// select.hpp - Measuring timers, and selecting the best POSIX clock at startup
+
+// Copyright Joel P. C. Filho 2019 - 2019
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EMB_INCLUDED_TIMERS_SELECT_HPP
+#define EMB_INCLUDED_TIMERS_SELECT_HPP
+
+#include <emb/emb.hpp>
+#include <emb/timers/posix.hpp>
+#include <time.h>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace emb {
+
+/// Measured characteristics of a timer
+struct TimerCharacteristics {
+  /// Name of the timer, for reports
+  const char* name;
+  /// Smallest nonzero difference between two readings, in nanoseconds
+  double resolution_ns;
+  /// Mean cost of a reading, in nanoseconds
+  double overhead_ns;
+  /// Whether no reading was earlier than the one before it
+  bool monotonic;
+  /// Whether readings stayed ordered while moving the thread across CPUs. Tested on Linux only.
+  bool consistent;
+};
+
+namespace detail {
+
+/// A timer duration in nanoseconds, from the timer's period, or as is if it's unknown
+template <typename Timer>
+inline double toNanoseconds(const default_duration_t<Timer>& d) noexcept {
+  using ticks = typename conditional<period<Timer>::den != 0, Timer,
+      default_duration_t<Timer>>::type;
+  double value = static_cast<double>(count(d));
+  return period<ticks>::den ? value * 1e9 * period<ticks>::num / period<ticks>::den : value;
+}
+
+/// Whether readings across all CPUs the thread may run on are ordered. The thread's affinity is
+/// restored afterwards.
+template <typename Timer>
+inline bool consistentAcrossCpus() noexcept {
+#ifdef __linux__
+  cpu_set_t allowed;
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+    return true;
+  bool consistent = true;
+  default_time_point_t<Timer> last = Timer::now();
+  for (int round = 0; round < 4; round++) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (!CPU_ISSET(cpu, &allowed))
+        continue;
+      cpu_set_t one;
+      CPU_ZERO(&one);
+      CPU_SET(cpu, &one);
+      if (sched_setaffinity(0, sizeof(one), &one) != 0)
+        continue;
+      default_time_point_t<Timer> now = Timer::now();
+      if (now < last)
+        consistent = false;
+      last = now;
+    }
+  }
+  sched_setaffinity(0, sizeof(allowed), &allowed);
+  return consistent;
+#else
+  return true;
+#endif
+}
+
+}  // namespace detail
+
+/// Measures a timer's resolution, overhead, monotonicity and consistency across CPUs.
+/// Takes up to a few tens of milliseconds, more for coarse timers.
+template <typename Timer>
+inline TimerCharacteristics characterizeTimer(const char* name) {
+  using time_point = detail::default_time_point_t<Timer>;
+  TimerCharacteristics c{name, 0.0, 0.0, true, true};
+
+  // Resolution: differences between consecutive changes of the reading. The first change is
+  // skipped, as it's only part of a tick. Stops early for coarse timers.
+  double spent = 0.0;
+  time_point last = Timer::now();
+  for (int round = 0; round <= 100 && spent < 20000000.0; round++) {
+    time_point now;
+    do {
+      now = Timer::now();
+    } while (!(now < last) && !(last < now));
+    if (now < last) {
+      c.monotonic = false;
+    } else if (round) {
+      double d = detail::toNanoseconds<Timer>(now - last);
+      spent += d;
+      if (c.resolution_ns == 0.0 || d < c.resolution_ns)
+        c.resolution_ns = d;
+    }
+    last = now;
+  }
+
+  // Overhead: mean time of consecutive readings, on the monotonic clock
+  constexpr int readings = 10000;
+  long long start = MonotonicTimer::now();
+  last = Timer::now();
+  for (int i = 1; i < readings; i++) {
+    time_point now = Timer::now();
+    if (now < last)
+      c.monotonic = false;
+    last = now;
+  }
+  c.overhead_ns = static_cast<double>(MonotonicTimer::now() - start) / readings;
+
+  c.consistent = detail::consistentAcrossCpus<Timer>();
+  return c;
+}
+
+/// Index of the best timer for benchmarks whose iterations take about granularity_ns: of the
+/// timers that are monotonic and consistent, if any, the one with the least overhead among those
+/// with a resolution within 1% of the granularity, or else the one with the finest resolution.
+inline size_t chooseTimer(
+    const TimerCharacteristics* timers, size_t count, double granularity_ns) noexcept {
+  bool any_reliable = false;
+  for (size_t i = 0; i < count; i++)
+    any_reliable = any_reliable || (timers[i].monotonic && timers[i].consistent);
+
+  size_t best = count;
+  bool best_fine = false;
+  for (size_t i = 0; i < count; i++) {
+    const TimerCharacteristics& t = timers[i];
+    if (any_reliable && !(t.monotonic && t.consistent))
+      continue;
+    bool fine = t.resolution_ns <= granularity_ns / 100;
+    if (best == count || (fine && !best_fine)) {
+      best = i;
+      best_fine = fine;
+      continue;
+    }
+    const TimerCharacteristics& b = timers[best];
+    if (fine == best_fine && (fine ? t.overhead_ns < b.overhead_ns
+                                   : t.resolution_ns < b.resolution_ns))
+      best = i;
+  }
+  return best;
+}
+
+/// Timer reading the POSIX clock chosen by selectTimer, in nanoseconds.
+/// Reads CLOCK_MONOTONIC until a clock is selected.
+struct SelectedTimer {
+  using period = detail::nanoseconds_period;
+
+  static long long now() noexcept { return detail::clockNanoseconds(clock()); }
+
+  /// The clock read by now()
+  static clockid_t& clock() noexcept {
+    static clockid_t c = CLOCK_MONOTONIC;
+    return c;
+  }
+};
+
+/// Measures the wall-time POSIX clocks of this host, and selects the best for benchmarks whose
+/// iterations take about granularity_ns, as with chooseTimer, to be read by SelectedTimer.
+/// Adds the choice to the context, as "timer", "timer_resolution_ns", "timer_overhead_ns",
+/// "timer_monotonic" and "timer_consistent". Returns the selected clock's characteristics.
+/// CPU-time clocks aren't candidates, as they measure something else.
+template <size_t N>
+inline TimerCharacteristics selectTimer(double granularity_ns, Properties<N>& context) {
+  TimerCharacteristics timers[3];
+  clockid_t clocks[3];
+  size_t count = 0;
+#ifdef CLOCK_MONOTONIC_RAW
+  timers[count] = characterizeTimer<MonotonicRawTimer>("CLOCK_MONOTONIC_RAW");
+  clocks[count++] = CLOCK_MONOTONIC_RAW;
+#endif
+  timers[count] = characterizeTimer<MonotonicTimer>("CLOCK_MONOTONIC");
+  clocks[count++] = CLOCK_MONOTONIC;
+#ifdef CLOCK_MONOTONIC_COARSE
+  timers[count] = characterizeTimer<PosixTimer<CLOCK_MONOTONIC_COARSE>>("CLOCK_MONOTONIC_COARSE");
+  clocks[count++] = CLOCK_MONOTONIC_COARSE;
+#endif
+
+  size_t best = chooseTimer(timers, count, granularity_ns);
+  const TimerCharacteristics& t = timers[best];
+  SelectedTimer::clock() = clocks[best];
+  context.set("timer", t.name);
+  context.set("timer_resolution_ns", t.resolution_ns);
+  context.set("timer_overhead_ns", t.overhead_ns);
+  context.set("timer_monotonic", t.monotonic ? "yes" : "no");
+  context.set("timer_consistent", t.consistent ? "yes" : "no");
+  return t;
+}
+
+}  // namespace emb
+
+#endif
@@ -0,0 +1,61 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// simulated.hpp - Narrow hardware counters simulated on POSIX hosts, for testing
+
+// Copyright Joel P. C. Filho 2019 - 2019
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EMB_INCLUDED_TIMERS_SIMULATED_HPP
+#define EMB_INCLUDED_TIMERS_SIMULATED_HPP
+
+#include <emb/emb.hpp>
+#include <time.h>
+
+namespace emb {
+
+/// A free-running counter of Bits bits, incrementing at Frequency Hz, simulated with the
+/// monotonic clock. For testing WrappingTimer, or code for a target, on a POSIX host.
+template <unsigned Bits, unsigned long long Frequency>
+struct SimulatedCounter {
+  static_assert(Bits > 0 && Bits < 64, "SimulatedCounter supports counters of 1 to 63 bits");
+
+  /// Tick period, as num / den seconds
+  struct period {
+    static constexpr long long num = 1;
+    static constexpr long long den = Frequency;
+  };
+
+  /// Counter value, wrapped to Bits bits
+  static unsigned long long now() noexcept { return ticks() & ((1ull << Bits) - 1); }
+
+ protected:
+  /// Ticks since the first call, without wrapping
+  static unsigned long long ticks() noexcept {
+    static const unsigned long long start = nanoseconds();
+    unsigned long long elapsed = nanoseconds() - start;
+    // Split to avoid overflowing elapsed * Frequency
+    unsigned long long seconds = elapsed / 1000000000ull;
+    return seconds * Frequency + (elapsed - seconds * 1000000000ull) * Frequency / 1000000000ull;
+  }
+
+ private:
+  static unsigned long long nanoseconds() noexcept {
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return static_cast<unsigned long long>(t.tv_sec) * 1000000000ull +
+           static_cast<unsigned long long>(t.tv_nsec);
+  }
+};
+
+/// A SimulatedCounter that also counts its overflows, as an overflow interrupt would
+template <unsigned Bits, unsigned long long Frequency>
+struct SimulatedOverflowCounter : SimulatedCounter<Bits, Frequency> {
+  /// Number of overflows since the first call
+  static unsigned long long overflows() noexcept {
+    return SimulatedCounter<Bits, Frequency>::ticks() >> Bits;
+  }
+};
+
+}  // namespace emb
+
+#endif
@@ -0,0 +1,135 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// wrapping.hpp - 64-bit timer from a narrow, wrapping hardware counter
+
+// Copyright Joel P. C. Filho 2019 - 2019
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EMB_INCLUDED_TIMERS_WRAPPING_HPP
+#define EMB_INCLUDED_TIMERS_WRAPPING_HPP
+
+#include <emb/emb.hpp>
+
+namespace emb {
+
+namespace detail {
+
+/// Whether Counter provides overflows(), a running count of its overflows
+template <typename Counter>
+struct has_overflows {
+ private:
+  template <typename C>
+  static char test(decltype(C::overflows())*);
+  template <typename C>
+  static long test(...);
+
+ public:
+  static constexpr bool value = sizeof(test<Counter>(nullptr)) == sizeof(char);
+};
+
+/// Tag for selecting overloads on a compile-time condition
+template <bool Value>
+struct BoolTag {};
+
+}  // namespace detail
+
+/// Timer adapter for free-running counters of Bits bits, which may wrap between two readings.
+/// Readings are extended to 64 bits in software, so differences are correct across wraps.
+///
+/// Counter provides a static now(), returning the counter value (bits above Bits are ignored),
+/// and optionally:
+///   - period, the tick period as a std::ratio-like type, forwarded to the Benchmarker;
+///   - overflows(), a running count of overflows (e.g. incremented by an interrupt, accounting for
+///     a pending one), making the extension exact even with several wraps between readings.
+///
+/// Without overflows(), only the counter's value modulo its range is known, so every interval
+/// must be shorter than the range. Measured intervals of at least half the range are counted as
+/// ambiguous, and the Benchmarker reports their count in each result's "ambiguous_samples"
+/// counter, if nonzero. Unmeasured time between iterations, e.g. cache eviction, isn't checked.
+/// Longer intervals can't be detected: one of 1.07 times the range reads as 0.07 times the range,
+/// unflagged. Provide overflows() for iterations that may be that long.
+///
+/// The extension state is static, shared by all users of the same WrappingTimer type. Reading it
+/// from interrupts or multiple threads is not supported.
+template <typename Counter, unsigned Bits>
+struct WrappingTimer : detail::counter_period<Counter> {
+  static_assert(Bits > 1 && Bits < 64, "WrappingTimer supports counters of 2 to 63 bits");
+
+  /// Number of distinct counter values
+  static constexpr unsigned long long range = 1ull << Bits;
+
+  /// Counter reading, extended to 64 bits
+  struct time_point {
+    unsigned long long value;
+
+    /// Ticks between two readings. Counts the interval as ambiguous if it's at least half the
+    /// range, without overflows().
+    friend unsigned long long operator-(const time_point& end, const time_point& start) noexcept {
+      return elapsed(end.value - start.value);
+    }
+
+    friend bool operator<(const time_point& a, const time_point& b) noexcept {
+      return a.value < b.value;
+    }
+
+   private:
+    static unsigned long long elapsed(unsigned long long ticks) noexcept {
+      if (!detail::has_overflows<Counter>::value && ticks >= range / 2)
+        state().ambiguous++;
+      return ticks;
+    }
+  };
+
+  /// Counter value, extended to 64 bits
+  static time_point now() noexcept {
+    return {read(detail::BoolTag<detail::has_overflows<Counter>::value>{})};
+  }
+
+  /// Number of ambiguous intervals since the last call.
+  /// The Benchmarker calls it before and after each benchmark.
+  static size_t takeAmbiguous() noexcept {
+    State& s = state();
+    size_t n = s.ambiguous;
+    s.ambiguous = 0;
+    return n;
+  }
+
+ private:
+  struct State {
+    unsigned long long last;
+    size_t ambiguous;
+  };
+
+  static State& state() noexcept {
+    static State s{0, 0};
+    return s;
+  }
+
+  static unsigned long long raw() noexcept {
+    return static_cast<unsigned long long>(Counter::now()) & (range - 1);
+  }
+
+  /// Extension from the wraps observed between readings
+  static unsigned long long read(detail::BoolTag<false>) noexcept {
+    State& s = state();
+    unsigned long long value = raw();
+    unsigned long long previous = s.last & (range - 1);
+    s.last += (value - previous) & (range - 1);
+    return s.last;
+  }
+
+  /// Exact extension from the counter's overflow count
+  static unsigned long long read(detail::BoolTag<true>) noexcept {
+    unsigned long long overflows;
+    unsigned long long value;
+    do {
+      overflows = static_cast<unsigned long long>(Counter::overflows());
+      value = raw();
+    } while (overflows != static_cast<unsigned long long>(Counter::overflows()));
+    return overflows * range + value;
+  }
+};
+
+}  // namespace emb
+
+#endif
@@ -0,0 +1,107 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// usage.hpp - Resource usage of each benchmark run: memory, page faults, context switches
+
+// Copyright Joel P. C. Filho 2019 - 2019
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EMB_INCLUDED_USAGE_HPP
+#define EMB_INCLUDED_USAGE_HPP
+
+#include <emb/emb.hpp>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+
+namespace emb {
+
+namespace detail {
+
+/// Value of a "Key: N kB" line of /proc/self/status, in kB, or -1 if unavailable
+inline long long statusKilobytes(const char* key) {
+  FILE* f = fopen("/proc/self/status", "r");
+  if (!f)
+    return -1;
+  long long value = -1;
+  size_t length = strlen(key);
+  char line[256];
+  while (fgets(line, sizeof(line), f)) {
+    if (strncmp(line, key, length) == 0 && line[length] == ':') {
+      value = strtoll(line + length + 1, nullptr, 10);
+      break;
+    }
+  }
+  fclose(f);
+  return value;
+}
+
+/// Resets the peak resident set size of the process. Returns false if it's unsupported.
+inline bool resetPeakResidentSet() {
+  FILE* f = fopen("/proc/self/clear_refs", "w");
+  if (!f)
+    return false;
+  bool ok = fputs("5", f) >= 0;
+  return fclose(f) == 0 && ok;
+}
+
+/// ru_maxrss in kB: it's in bytes on macOS
+inline long long maxResidentKilobytes(const rusage& usage) noexcept {
+#ifdef __APPLE__
+  return static_cast<long long>(usage.ru_maxrss) / 1024;
+#else
+  return static_cast<long long>(usage.ru_maxrss);
+#endif
+}
+
+}  // namespace detail
+
+/// Monitor for Benchmarker::monitor, adding the process's resource usage during each benchmark
+/// run, from getrusage and /proc/self/status, as counters:
+///   - max_rss_delta_kb: growth of the peak resident set size over the resident set size before
+///     the run, in kB. Where the peak can't be reset (before Linux 4.0, or outside Linux), only
+///     growth past the process's earlier peak is seen.
+///   - minor_faults, major_faults: page faults per iteration, without and with I/O
+///   - voluntary_switches, involuntary_switches: context switches per iteration, from blocking
+///     and from preemption
+/// Usage is of the whole process, including its other threads, if any.
+/// Set EMB_COUNTERS_SIZE to fit these 5 counters, those the Benchmarker adds, and any other.
+class ResourceUsage {
+ public:
+  void begin() {
+    peak_reset_ = detail::resetPeakResidentSet();
+    resident_kb_ = detail::statusKilobytes("VmRSS");
+    getrusage(RUSAGE_SELF, &start_);
+  }
+
+  template <size_t N>
+  void end(Properties<N>& counters, size_t iterations) {
+    static_assert(N >= 5 + detail::library_counters,
+        "ResourceUsage adds 5 counters to the Benchmarker's: increase EMB_COUNTERS_SIZE");
+    rusage now;
+    getrusage(RUSAGE_SELF, &now);
+
+    long long peak_kb = peak_reset_ ? detail::statusKilobytes("VmHWM") : -1;
+    if (peak_kb >= 0 && resident_kb_ >= 0)
+      counters.set("max_rss_delta_kb", peak_kb - resident_kb_);
+    else
+      counters.set("max_rss_delta_kb",
+          detail::maxResidentKilobytes(now) - detail::maxResidentKilobytes(start_));
+
+    double n = static_cast<double>(iterations ? iterations : 1);
+    counters.set("minor_faults", static_cast<double>(now.ru_minflt - start_.ru_minflt) / n);
+    counters.set("major_faults", static_cast<double>(now.ru_majflt - start_.ru_majflt) / n);
+    counters.set("voluntary_switches", static_cast<double>(now.ru_nvcsw - start_.ru_nvcsw) / n);
+    counters.set(
+        "involuntary_switches", static_cast<double>(now.ru_nivcsw - start_.ru_nivcsw) / n);
+  }
+
+ private:
+  rusage start_{};
+  long long resident_kb_{-1};
+  bool peak_reset_{false};
+};
+
+}  // namespace emb
+
+#endif
@@ -0,0 +1,279 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// characterize - Measures the timer and memory hierarchy of a host, writing a machine profile
+//
+// Usage: characterize [--output=FILE] [--max-bytes=N] [--bandwidth-bytes=N]
+//   --output           profile file to write (default: standard output)
+//   --max-bytes        largest working set for the latency sweep (default: 2x the last-level
+//                      cache, up to 256MiB)
+//   --bandwidth-bytes  buffer size for the bandwidth kernels (default: 4x the last-level cache,
+//                      from 64MiB to 512MiB)
+//
+// Progress and a summary are written to standard error.
+// See emb/profile.hpp for the profile format and its keys.
+
+// Copyright Joel P. C. Filho 2019 - 2019
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include <emb/emb.hpp>
+#include <emb/host.hpp>
+#include <emb/profile.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+using Statistics = emb::statistics::Set<emb::statistics::Welford, emb::statistics::Min>;
+using Benchmarker =
+    emb::Benchmarker<Clock, std::chrono::duration<double, std::nano>, 0, Statistics>;
+
+/// Profile entries, with storage for their generated keys
+struct Profile {
+  emb::Properties<128> properties;
+  std::deque<std::string> keys;
+
+  template <typename T>
+  void set(const std::string& key, T value) {
+    keys.push_back(key);
+    properties.set(keys.back().c_str(), value);
+  }
+};
+
+/// Mean and minimum time of an iteration, in nanoseconds
+struct Measurement {
+  double mean;
+  double min;
+};
+
+/// Runs a callable as a benchmark, measuring its iterations
+template <typename Callable>
+Measurement measure(const char* name, size_t iterations, Callable&& callable) {
+  Benchmarker benchmarker(iterations);
+  benchmarker.registerBenchmark(name, static_cast<Callable&&>(callable));
+  auto results = benchmarker.run();
+  auto& r = results.front();
+  auto min = r.statistics.get<emb::statistics::Min>().min();
+  return {r.mean.count(), Benchmarker::Conversion::toAccumulator(min).count()};
+}
+
+/// Smallest nonzero difference between two readings of the clock
+double timerResolution() {
+  auto best = Clock::duration::max();
+  for (int i = 0; i < 1000; i++) {
+    auto start = Clock::now();
+    auto now = start;
+    while (now == start)
+      now = Clock::now();
+    best = std::min(best, now - start);
+  }
+  return std::chrono::duration<double, std::nano>(best).count();
+}
+
+/// Cache line, for pointer chasing
+struct alignas(64) Line {
+  Line* next;
+};
+
+/// Latency of dependent loads over a working set of size bytes, in nanoseconds
+double chaseLatency(size_t size) {
+  constexpr size_t hops = 1024;
+  size_t count = std::max<size_t>(size / sizeof(Line), 2);
+  std::vector<Line> lines(count);
+
+  // A single random cycle through all lines, so hardware prefetchers can't follow
+  std::vector<size_t> order(count);
+  for (size_t i = 0; i < count; i++)
+    order[i] = i;
+  std::mt19937_64 random(count);
+  for (size_t i = count - 1; i > 0; i--)
+    std::swap(order[i], order[std::uniform_int_distribution<size_t>(0, i - 1)(random)]);
+  for (size_t i = 0; i < count; i++)
+    lines[order[i]].next = &lines[order[(i + 1) % count]];
+
+  // Warm up, bringing the working set into the caches it fits
+  Line* p = &lines[0];
+  for (size_t i = 0; i < count; i++)
+    p = p->next;
+
+  Line** cursor = &p;
+  auto m = measure("latency", 200, [cursor](Benchmarker::State& s) {
+    Line* q = *cursor;
+    for (auto _ : s) {
+      for (size_t i = 0; i < hops; i++)
+        q = q->next;
+      emb::dontOptimize(q);
+    }
+    *cursor = q;
+  });
+  return m.min / hops;
+}
+
+/// A cache level found in the latency sweep
+struct CacheLevel {
+  size_t bytes;
+  double latency_ns;
+};
+
+/// Finds cache levels as plateaus in the latency curve, split where latency grows by over 40%.
+/// If the sweep reached memory, the last plateau is memory, and isn't a cache level.
+std::vector<CacheLevel> findCacheLevels(
+    const std::vector<std::pair<size_t, double>>& sweep, bool reached_memory) {
+  std::vector<CacheLevel> levels;
+  if (sweep.empty())
+    return levels;
+  CacheLevel current{sweep.front().first, sweep.front().second};
+  for (size_t i = 1; i < sweep.size(); i++) {
+    if (sweep[i].second > 1.4 * current.latency_ns) {
+      levels.push_back(current);
+      current = {sweep[i].first, sweep[i].second};
+    } else {
+      current.bytes = sweep[i].first;
+    }
+  }
+  if (!reached_memory)
+    levels.push_back(current);
+  return levels;
+}
+
+/// Bandwidth of a kernel over a buffer, in GB/s
+template <typename Kernel>
+double bandwidth(const char* name, size_t bytes, Kernel&& kernel) {
+  kernel();
+  auto m = measure(name, 5, [&kernel](Benchmarker::State& s) {
+    for (auto _ : s)
+      kernel();
+  });
+  return bytes / m.min;
+}
+
+int main(int argc, char** argv) {
+  const char* output = nullptr;
+  size_t max_bytes = 0;
+  size_t bandwidth_bytes = 0;
+
+  for (int i = 1; i < argc; i++) {
+    if (std::strncmp(argv[i], "--output=", 9) == 0) {
+      output = argv[i] + 9;
+    } else if (std::strncmp(argv[i], "--max-bytes=", 12) == 0) {
+      max_bytes = std::strtoull(argv[i] + 12, nullptr, 0);
+    } else if (std::strncmp(argv[i], "--bandwidth-bytes=", 18) == 0) {
+      bandwidth_bytes = std::strtoull(argv[i] + 18, nullptr, 0);
+    } else {
+      std::fprintf(stderr,
+          "usage: %s [--output=FILE] [--max-bytes=N] [--bandwidth-bytes=N]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  constexpr size_t MiB = 1024 * 1024;
+  size_t llc = emb::lastLevelCacheSize();
+  if (!max_bytes)
+    max_bytes = llc ? std::min(2 * llc, 256 * MiB) : 64 * MiB;
+  if (!bandwidth_bytes)
+    bandwidth_bytes = std::max(64 * MiB, std::min(4 * llc, 512 * MiB));
+
+  Profile profile;
+  emb::describeHost(profile.properties);
+
+  // Timer
+  double resolution = timerResolution();
+  auto empty = measure("empty", 100000, [](Benchmarker::State& s) {
+    for (auto _ : s) {
+    }
+  });
+  std::fprintf(stderr, "timer: resolution %.1fns, overhead %.1fns (min %.1fns)\n", resolution,
+      empty.mean, empty.min);
+  profile.set("timer_resolution_ns", resolution);
+  profile.set("timer_overhead_ns", empty.mean);
+  profile.set("timer_overhead_min_ns", empty.min);
+
+  // Optimization barriers, as the mean cost of 1000 calls above the empty loop
+  auto dont_optimize = measure("dont_optimize", 10000, [](Benchmarker::State& s) {
+    for (auto _ : s)
+      for (int i = 0; i < 1000; i++)
+        emb::dontOptimize(i);
+  });
+  auto clobber_memory = measure("clobber_memory", 10000, [](Benchmarker::State& s) {
+    for (auto _ : s)
+      for (int i = 0; i < 1000; i++)
+        emb::clobberMemory();
+  });
+  double dont_optimize_ns = std::max(0.0, (dont_optimize.mean - empty.mean) / 1000);
+  double clobber_memory_ns = std::max(0.0, (clobber_memory.mean - empty.mean) / 1000);
+  std::fprintf(stderr, "dontOptimize: %.3fns, clobberMemory: %.3fns\n", dont_optimize_ns,
+      clobber_memory_ns);
+  profile.set("dont_optimize_ns", dont_optimize_ns);
+  profile.set("clobber_memory_ns", clobber_memory_ns);
+
+  // Latency sweep, over working sets growing by powers of two
+  std::vector<std::pair<size_t, double>> sweep;
+  for (size_t size = 4096; size <= max_bytes; size *= 2) {
+    double latency = chaseLatency(size);
+    std::fprintf(stderr, "latency: %zu bytes, %.2fns\n", size, latency);
+    sweep.emplace_back(size, latency);
+    profile.set("latency_ns_" + std::to_string(size), latency);
+  }
+  // Memory is only measured past twice the last-level cache. Otherwise, all plateaus are caches.
+  bool reached_memory = llc && !sweep.empty() && sweep.back().first >= 2 * llc;
+  if (reached_memory)
+    profile.set("memory_latency_ns", sweep.back().second);
+  else
+    std::fprintf(stderr, "latency: memory not reached, below twice the last-level cache\n");
+
+  auto levels = findCacheLevels(sweep, reached_memory);
+  profile.set("cache_levels", static_cast<unsigned long>(levels.size()));
+  for (size_t i = 0; i < levels.size(); i++) {
+    std::string prefix = "cache_l" + std::to_string(i + 1);
+    std::fprintf(stderr, "cache L%zu: %zu bytes, %.2fns\n", i + 1, levels[i].bytes,
+        levels[i].latency_ns);
+    profile.set(prefix + "_bytes", static_cast<unsigned long>(levels[i].bytes));
+    profile.set(prefix + "_latency_ns", levels[i].latency_ns);
+  }
+
+  // Bandwidth, with streaming kernels over a buffer larger than the caches, if possible
+  std::vector<std::uint64_t> buffer(bandwidth_bytes / sizeof(std::uint64_t), 1);
+  size_t bytes = buffer.size() * sizeof(std::uint64_t);
+  profile.set("bandwidth_buffer_bytes", static_cast<unsigned long>(bytes));
+  double read = bandwidth("read", bytes, [&buffer] {
+    std::uint64_t sum = 0;
+    for (auto v : buffer)
+      sum += v;
+    emb::dontOptimize(sum);
+  });
+  double write = bandwidth("write", bytes, [&buffer] {
+    std::fill(buffer.begin(), buffer.end(), std::uint64_t{2});
+    emb::clobberMemory();
+  });
+  // Copying reads one half and writes the other, moving the buffer's size
+  size_t half = buffer.size() / 2;
+  double copy = bandwidth("copy", bytes, [&buffer, half] {
+    std::memcpy(buffer.data() + half, buffer.data(), half * sizeof(std::uint64_t));
+    emb::clobberMemory();
+  });
+  std::fprintf(stderr, "bandwidth: read %.2fGB/s, write %.2fGB/s, copy %.2fGB/s (%zu bytes)\n",
+      read, write, copy, bytes);
+  profile.set("read_bandwidth_gbps", read);
+  profile.set("write_bandwidth_gbps", write);
+  profile.set("copy_bandwidth_gbps", copy);
+
+  std::FILE* out = stdout;
+  if (output) {
+    out = std::fopen(output, "w");
+    if (!out) {
+      std::perror(output);
+      return 1;
+    }
+  }
+  emb::writeProfile(out, profile.properties);
+  if (out != stdout)
+    std::fclose(out);
+  return 0;
+}
@@ -0,0 +1,101 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// emb_decode - Converts a BinaryReporter stream to JSON or CSV
+//
+// Usage: emb_decode [--format=json|csv] [--unit-ns=N] [input]
+//   --format   output format (default: json)
+//   --unit-ns  nanoseconds per time unit, for timers without a known period (default: 1)
+//   input      file or device to read, such as a serial port (default: standard input)
+
+// Copyright Joel P. C. Filho 2019 - 2019
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+// Column storage of CsvReporter, for all the counters a decoded result may have
+#define EMB_COUNTERS_SIZE 32
+
+#include <emb/reporters/binary_decoder.hpp>
+#include <emb/reporters/csv.hpp>
+#include <emb/reporters/json.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/// Forwards decoded records to a reporter, keeping its output well-formed
+/// when the stream starts or ends in the middle of a run.
+template <typename Reporter>
+struct Session {
+  Reporter reporter;
+  bool running;
+
+  void begin(const emb::BinaryDecoder::Context& context) {
+    if (running)
+      reporter.end();
+    reporter.begin(context);
+    running = true;
+  }
+
+  void report(const emb::DecodedResult& result) {
+    if (!running)
+      begin({});
+    reporter.report(result);
+  }
+
+  void end() {
+    if (running)
+      reporter.end();
+    running = false;
+  }
+};
+
+template <typename Reporter>
+int decode(std::FILE* input, double unit_ns) {
+  emb::BinaryDecoder decoder(unit_ns);
+  Session<Reporter> session{Reporter(stdout), false};
+  unsigned char buffer[4096];
+  size_t size;
+  while ((size = std::fread(buffer, 1, sizeof(buffer), input)) > 0)
+    decoder.decode(buffer, size, session);
+  size_t left = decoder.finish(session);
+  session.end();
+  if (left)
+    std::fprintf(stderr, "emb_decode: %zu bytes left in an unterminated frame\n", left);
+  if (decoder.errors())
+    std::fprintf(stderr, "emb_decode: %zu corrupted frames skipped\n", decoder.errors());
+  return decoder.errors() || left ? 2 : 0;
+}
+
+int main(int argc, char** argv) {
+  const char* format = "json";
+  const char* path = nullptr;
+  double unit_ns = 1.0;
+
+  for (int i = 1; i < argc; i++) {
+    if (std::strncmp(argv[i], "--format=", 9) == 0) {
+      format = argv[i] + 9;
+    } else if (std::strncmp(argv[i], "--unit-ns=", 10) == 0) {
+      unit_ns = std::atof(argv[i] + 10);
+    } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+      std::fprintf(stderr, "usage: %s [--format=json|csv] [--unit-ns=N] [input]\n", argv[0]);
+      return 1;
+    } else {
+      path = argv[i];
+    }
+  }
+
+  std::FILE* input = stdin;
+  if (path && std::strcmp(path, "-") != 0) {
+    input = std::fopen(path, "rb");
+    if (!input) {
+      std::perror(path);
+      return 1;
+    }
+  }
+
+  if (std::strcmp(format, "csv") == 0)
+    return decode<emb::CsvReporter>(input, unit_ns);
+  if (std::strcmp(format, "json") == 0)
+    return decode<emb::JsonReporter>(input, unit_ns);
+  std::fprintf(stderr, "emb_decode: unknown format '%s'\n", format);
+  return 1;
+}
@@ -0,0 +1,134 @@
+// Embedded MicroBenchmarks (EMB) - https://github.com/JoelFilho/EMB
+// emb_merge - Merges the BinaryReporter streams of several shards into one JSON or CSV report
+//
+// Usage: emb_merge [--format=json|csv] [--unit-ns=N] shard...
+//   --format   output format (default: json)
+//   --unit-ns  nanoseconds per time unit, for timers without a known period (default: 1)
+//   shard      file written by a shard, e.g. with --shard=I/N --format=binary --out=FILE
+//
+// The merged context is the first shard's, without its shard_index, and with shard_count set
+// to the number of merged files. Results are written in the order of the files.
+
+// Copyright Joel P. C. Filho 2019 - 2019
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE.md or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+// Column storage of CsvReporter, for all the counters a decoded result may have
+#define EMB_COUNTERS_SIZE 32
+
+#include <emb/reporters/binary_decoder.hpp>
+#include <emb/reporters/csv.hpp>
+#include <emb/reporters/json.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+/// Records decoded from one shard's stream
+struct Shard {
+  emb::BinaryDecoder::Context context;
+  std::vector<emb::DecodedResult> results;
+  bool has_context{false};
+
+  void begin(const emb::BinaryDecoder::Context& c) {
+    if (!has_context)
+      context = c;
+    has_context = true;
+  }
+
+  void report(const emb::DecodedResult& result) { results.push_back(result); }
+
+  void end() {}
+};
+
+template <typename Reporter>
+void write(const std::vector<Shard>& shards) {
+  emb::BinaryDecoder::Context context;
+  for (auto& shard : shards) {
+    if (!shard.has_context)
+      continue;
+    for (auto& p : shard.context) {
+      if (std::strcmp(p.key, "shard_index") == 0)
+        continue;
+      context.set(p);
+    }
+    break;
+  }
+  context.set("shard_count", static_cast<unsigned long long>(shards.size()));
+
+  Reporter reporter(stdout);
+  reporter.begin(context);
+  for (auto& shard : shards)
+    for (auto& result : shard.results)
+      reporter.report(result);
+  reporter.end();
+}
+
+int main(int argc, char** argv) {
+  const char* format = "json";
+  double unit_ns = 1.0;
+  std::vector<const char*> paths;
+
+  for (int i = 1; i < argc; i++) {
+    if (std::strncmp(argv[i], "--format=", 9) == 0) {
+      format = argv[i] + 9;
+    } else if (std::strncmp(argv[i], "--unit-ns=", 10) == 0) {
+      unit_ns = std::atof(argv[i] + 10);
+    } else if (argv[i][0] == '-') {
+      paths.clear();
+      break;
+    } else {
+      paths.push_back(argv[i]);
+    }
+  }
+  if (paths.empty()) {
+    std::fprintf(stderr, "usage: %s [--format=json|csv] [--unit-ns=N] shard...\n", argv[0]);
+    return 1;
+  }
+  if (std::strcmp(format, "csv") != 0 && std::strcmp(format, "json") != 0) {
+    std::fprintf(stderr, "emb_merge: unknown format '%s'\n", format);
+    return 1;
+  }
+
+  // Decoders own the decoded strings, so they're kept until the report is written
+  std::vector<std::unique_ptr<emb::BinaryDecoder>> decoders;
+  std::vector<Shard> shards(paths.size());
+  int status = 0;
+  for (size_t i = 0; i < paths.size(); i++) {
+    std::FILE* input = std::fopen(paths[i], "rb");
+    if (!input) {
+      std::perror(paths[i]);
+      return 1;
+    }
+    decoders.emplace_back(new emb::BinaryDecoder(unit_ns));
+    unsigned char buffer[4096];
+    size_t size;
+    while ((size = std::fread(buffer, 1, sizeof(buffer), input)) > 0)
+      decoders.back()->decode(buffer, size, shards[i]);
+    std::fclose(input);
+    if (size_t left = decoders.back()->finish(shards[i])) {
+      std::fprintf(stderr, "emb_merge: %s: %zu bytes left in an unterminated frame\n", paths[i],
+          left);
+      status = 2;
+    }
+
+    if (decoders.back()->errors()) {
+      std::fprintf(stderr, "emb_merge: %s: %zu corrupted frames skipped\n", paths[i],
+          decoders.back()->errors());
+      status = 2;
+    }
+    const emb::Property* count = shards[i].context.find("shard_count");
+    if (count && count->type == emb::Property::Type::Unsigned &&
+        count->unsigned_value != paths.size())
+      std::fprintf(stderr, "emb_merge: %s: shard of %llu, but %zu files are merged\n", paths[i],
+          count->unsigned_value, paths.size());
+  }
+
+  if (std::strcmp(format, "csv") == 0)
+    write<emb::CsvReporter>(shards);
+  else
+    write<emb::JsonReporter>(shards);
+  return status;
+}